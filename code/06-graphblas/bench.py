@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Benchmark ./main over a set of graphs and modes.
+
+Each (graph, mode) pair runs in --procs separate processes of
+./main -r (warmup + reps).  The per-region JSON lines from -j are
+collected, the first `warmup` runs of every process dropped, and the
+rest summarized as median / p10 / p90 / min / max wall time, edges per
+second and memory.  Results go to --out as JSON; with --baseline, any
+region whose median is more than --tolerance slower than the baseline
+is reported and the exit status is 1.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+MODES = ("bfs", "pagerank", "full", "cc", "tc")
+
+
+def percentile(xs, p):
+    """Nearest-rank percentile of a non-empty list."""
+    xs = sorted(xs)
+    k = max(0, min(len(xs) - 1, int(round(p / 100.0 * (len(xs) - 1)))))
+    return xs[k]
+
+
+def summarize(xs):
+    return {
+        "n": len(xs),
+        "median": percentile(xs, 50),
+        "p10": percentile(xs, 10),
+        "p90": percentile(xs, 90),
+        "min": min(xs),
+        "max": max(xs),
+    }
+
+
+def run_once(main, graph, mode, runs, extra):
+    """One ./main process; returns (region records, pagerank iterations)."""
+    fd, jpath = tempfile.mkstemp(suffix=".json")
+    os.close(fd)
+    try:
+        cmd = [main, "-m", mode, "-r", str(runs), "-j", jpath,
+               "-o", os.devnull] + extra + [graph]
+        res = subprocess.run(cmd, stdout=subprocess.PIPE,
+                             stderr=subprocess.PIPE, text=True)
+        if res.returncode != 0:
+            sys.stderr.write(res.stderr)
+            raise SystemExit("%s failed" % " ".join(cmd))
+        with open(jpath) as f:
+            recs = [json.loads(line) for line in f if line.strip()]
+    finally:
+        os.unlink(jpath)
+    m = re.search(r"PageRank: (\d+) iterations", res.stdout)
+    return recs, (int(m.group(1)) if m else None)
+
+
+def bench_one(args, graph, mode):
+    wall = {}
+    rss = []
+    gb_bytes = {}
+    nedges = None
+    iters = None
+    for _ in range(args.procs):
+        recs, it = run_once(args.main, graph, mode,
+                            args.warmup + args.reps, args.extra)
+        iters = it if it is not None else iters
+        for r in recs:
+            name = r["region"]
+            if name == "print":
+                continue
+            if name == "load":
+                nedges = r.get("nnz", nedges)
+            elif r.get("run", 0) < args.warmup:
+                continue
+            wall.setdefault(name, []).append(r["wall_ms"])
+            gb_bytes.setdefault(name, []).append(r["gb_bytes"])
+            rss.append(r["maxrss_kb"])
+
+    out = {"graph": os.path.basename(graph), "mode": mode,
+           "edges": nedges, "pagerank_iters": iters,
+           "maxrss_kb": max(rss) if rss else None, "regions": {}}
+    for name, xs in wall.items():
+        s = summarize(xs)
+        s["gb_bytes_median"] = percentile(gb_bytes[name], 50)
+        # Traversed edges per second: one sweep of A for BFS, one per
+        # iteration for PageRank.
+        if nedges and s["median"] > 0:
+            sweeps = {"bfs": 1, "pagerank": iters or 0}.get(name, 0)
+            if sweeps:
+                s["teps"] = sweeps * nedges / (s["median"] / 1.0e3)
+        out["regions"][name] = s
+    return out
+
+
+def print_table(results):
+    print("%-20s %-9s %-9s %10s %10s %10s %12s %10s" %
+          ("graph", "mode", "region", "median_ms", "p10_ms", "p90_ms",
+           "TEPS", "maxrss_kb"))
+    for r in results:
+        for name, s in sorted(r["regions"].items()):
+            teps = "%.3g" % s["teps"] if "teps" in s else "-"
+            print("%-20s %-9s %-9s %10.3f %10.3f %10.3f %12s %10s" %
+                  (r["graph"], r["mode"], name, s["median"], s["p10"],
+                   s["p90"], teps, r["maxrss_kb"]))
+
+
+def compare(results, baseline, tol):
+    base = {(b["graph"], b["mode"]): b for b in baseline}
+    slow = []
+    for r in results:
+        b = base.get((r["graph"], r["mode"]))
+        if b is None:
+            continue
+        for name, s in r["regions"].items():
+            bs = b["regions"].get(name)
+            if bs and bs["median"] > 0 and s["median"] > bs["median"] * (1.0 + tol):
+                slow.append((r["graph"], r["mode"], name,
+                             bs["median"], s["median"]))
+    for g, m, name, old, new in slow:
+        print("REGRESSION %s %s %s: %.3f ms -> %.3f ms (%+.1f%%)" %
+              (g, m, name, old, new, 100.0 * (new / old - 1.0)))
+    return not slow
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("graphs", nargs="+")
+    ap.add_argument("--main", default="./main")
+    ap.add_argument("--modes", default="bfs,pagerank,full")
+    ap.add_argument("--warmup", type=int, default=1)
+    ap.add_argument("--reps", type=int, default=5)
+    ap.add_argument("--procs", type=int, default=3)
+    ap.add_argument("--out", default="bench-results.json")
+    ap.add_argument("--baseline")
+    ap.add_argument("--tolerance", type=float, default=0.10)
+    ap.add_argument("--extra", default="",
+                    help="extra ./main arguments, space separated")
+    args = ap.parse_args()
+    args.extra = args.extra.split()
+
+    results = []
+    for g in args.graphs:
+        for mode in args.modes.split(","):
+            if mode not in MODES:
+                raise SystemExit("unknown mode %s" % mode)
+            results.append(bench_one(args, g, mode))
+
+    print_table(results)
+    with open(args.out, "w") as f:
+        json.dump(results, f, indent=1)
+
+    if args.baseline and os.path.exists(args.baseline):
+        with open(args.baseline) as f:
+            if not compare(results, json.load(f), args.tolerance):
+                sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
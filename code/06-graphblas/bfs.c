@@ -1,30 +1,67 @@
 #include <GraphBLAS.h>
 
+#include "graph.h"
+
+// Direction-optimizing BFS (Beamer, Asanovic & Patterson, SC'12).
+// Push expands the frontier q through A.  Pull has every unvisited
+// vertex look for a parent in q through A', which wins once the
+// frontier's out-edges outnumber the unexplored edges by ALPHA.  Go
+// back to push when a shrinking frontier drops below N / BETA.
+#define BFS_ALPHA 14
+#define BFS_BETA  24
+
 int bfs(GrB_Vector *level,
-        GrB_Matrix A, GrB_Index source,
+        struct graph *G, GrB_Index source,
         const GrB_Index max_level)
 {
-  GrB_Index N;
-  GrB_Matrix_nrows(&N, A);
+  GrB_Matrix A = G->A;
+  GrB_Index N = graph_nrows(G);
 
   if (N == 0) return 0;
 
   GrB_Vector_new(level, GrB_INT64, N);
 
+  GrB_Vector deg = graph_outdeg(G), qdeg;
+  GrB_Vector_new(&qdeg, GrB_INT64, N);
+
   GrB_Vector q;
   GrB_Vector_new(&q, GrB_BOOL, N);
   GrB_Vector_setElement(q, 1, source);
 
+  GrB_Index nq = 1, nq_prev = 0;
+  int64_t edges_unexplored = graph_nvals(G);
+  bool pull = false;
+
   int64_t depth;
   for (depth = 1; depth <= max_level; ++depth) {
-    GrB_assign(*level, q, GrB_NULL, depth, GrB_ALL, N, GrB_NULL);
-    GrB_vxm(q, *level, GrB_NULL, GrB_LOR_LAND_SEMIRING_BOOL, q, A, GrB_DESC_RC);
-    bool found_more;
-    GrB_reduce(&found_more, GrB_NULL, GrB_LOR_MONOID_BOOL, q, GrB_NULL);
-    if (!found_more) break;
+    GrB_assign(*level, q, GrB_NULL, depth, GrB_ALL, N, GrB_DESC_S);
+
+    int64_t edges_frontier = 0;
+    GrB_eWiseMult(qdeg, GrB_NULL, GrB_NULL, GrB_FIRST_INT64, deg, q, GrB_DESC_R);
+    GrB_reduce(&edges_frontier, GrB_NULL, GrB_PLUS_MONOID_INT64, qdeg, GrB_NULL);
+    edges_unexplored -= edges_frontier;
+
+    if (!pull)
+      pull = edges_frontier > edges_unexplored / BFS_ALPHA;
+    else
+      pull = !(nq < nq_prev && nq < N / BFS_BETA);
+
+    if (pull) {
+      // A' is built the first time any search pulls.
+      GxB_Vector_Option_set(q, GxB_SPARSITY_CONTROL, GxB_BITMAP);
+      GrB_mxv(q, *level, GrB_NULL, GxB_ANY_PAIR_BOOL, graph_transpose(G), q, GrB_DESC_RSC);
+    } else {
+      GxB_Vector_Option_set(q, GxB_SPARSITY_CONTROL, GxB_SPARSE);
+      GrB_vxm(q, *level, GrB_NULL, GxB_ANY_PAIR_BOOL, q, A, GrB_DESC_RSC);
+    }
+
+    nq_prev = nq;
+    GrB_Vector_nvals(&nq, q);
+    if (nq == 0) break;
   }
 
   GrB_free(&q);
-  
+  GrB_free(&qdeg);
+
   return depth;
 }
@@ -0,0 +1,46 @@
+#include <stdlib.h>
+#include <GraphBLAS.h>
+
+#include "graph.h"
+
+// Batched BFS from nsources seeds at once.  Row s of the k-by-N
+// frontier Q holds the frontier of the search from sources[s], so one
+// GrB_mxm per level advances all k searches in a single pass over A.
+// levels(s,v) is the 1-based level of v in the search from sources[s],
+// or absent if v was not reached within max_level.
+int bfs_batch(GrB_Matrix *levels,
+              struct graph *G, const GrB_Index *sources, GrB_Index nsources,
+              const GrB_Index max_level)
+{
+  GrB_Matrix A = G->A;
+  GrB_Index N = graph_nrows(G);
+
+  if (N == 0 || nsources == 0) return 0;
+
+  GrB_Matrix_new(levels, GrB_INT64, nsources, N);
+
+  GrB_Matrix Q;
+  GrB_Matrix_new(&Q, GrB_BOOL, nsources, N);
+  {
+    GrB_Index *rows = malloc(nsources * sizeof(*rows));
+    bool *t = malloc(nsources * sizeof(*t));
+    for (GrB_Index s = 0; s < nsources; ++s) { rows[s] = s; t[s] = true; }
+    GrB_Matrix_build(Q, rows, sources, t, nsources, GrB_LOR);
+    free(t);
+    free(rows);
+  }
+
+  int64_t depth;
+  for (depth = 1; depth <= max_level; ++depth) {
+    GrB_assign(*levels, Q, GrB_NULL, depth, GrB_ALL, nsources, GrB_ALL, N, GrB_DESC_S);
+    GrB_mxm(Q, *levels, GrB_NULL, GxB_ANY_PAIR_BOOL, Q, A, GrB_DESC_RSC);
+
+    GrB_Index nq;
+    GrB_Matrix_nvals(&nq, Q);
+    if (nq == 0) break;
+  }
+
+  GrB_free(&Q);
+
+  return depth;
+}
@@ -0,0 +1,183 @@
+// Convert a raw .bin triple dump into the CSR format of graph_csr.h.
+//
+// Usage: bin2csr [-w] [-s] in.bin out.csr
+//   -w  keep the dump's val array as edge weights
+//   -s  symmetrize by adding the transpose
+//
+// Rows are bucketed with a counting sort, columns sorted within each
+// row, and duplicates dropped keeping the first occurrence, matching
+// the GrB_FIRST_FP64 assembly read_dumped() used.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph_csr.h"
+
+struct entry {
+  uint64_t j;
+  uint64_t seq;
+  double x;
+};
+
+static int
+entry_cmp(const void *a_, const void *b_)
+{
+  const struct entry *a = a_, *b = b_;
+  if (a->j != b->j) return (a->j < b->j? -1 : 1);
+  return (a->seq < b->seq? -1 : a->seq > b->seq);
+}
+
+static void
+write_or_die(FILE *out, const void *buf, size_t len, uint32_t *crc)
+{
+  if (fwrite(buf, 1, len, out) != len) { perror("Write error"); exit(1); }
+  *crc = csr_crc32(*crc, buf, len);
+}
+
+int
+main(int argc, char **argv)
+{
+  int keep_weights = 0, symmetrize = 0;
+  int c;
+  while ((c = getopt(argc, argv, "ws")) != -1) {
+    switch (c) {
+    case 'w': keep_weights = 1; break;
+    case 's': symmetrize = 1; break;
+    default:
+      fprintf(stderr, "Usage: %s [-w] [-s] in.bin out.csr\n", argv[0]);
+      return 1;
+    }
+  }
+  if (argc - optind != 2) {
+    fprintf(stderr, "Usage: %s [-w] [-s] in.bin out.csr\n", argv[0]);
+    return 1;
+  }
+  const char *inname = argv[optind], *outname = argv[optind+1];
+
+  int fd = open(inname, O_RDONLY);
+  if (fd < 0) { perror(inname); return 1; }
+  struct stat st;
+  if (fstat(fd, &st) != 0) { perror(inname); return 1; }
+  if ((size_t)st.st_size < 3 * sizeof(uint64_t)) {
+    fprintf(stderr, "%s: too small for a matrix header\n", inname);
+    return 1;
+  }
+  const uint64_t *words = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (words == MAP_FAILED) { perror(inname); return 1; }
+  close(fd);
+
+  const uint64_t nrows = words[0], ncols = words[1], nin = words[2];
+  int has_val;
+  uint64_t stride = dump_stride(st.st_size / sizeof(uint64_t), nin, &has_val);
+  if (!stride && nin) {
+    fprintf(stderr, "%s: truncated, header claims %lu entries\n",
+            inname, (unsigned long)nin);
+    return 1;
+  }
+  if (symmetrize && nrows != ncols) {
+    fprintf(stderr, "%s: cannot symmetrize a %lu x %lu matrix\n",
+            inname, (unsigned long)nrows, (unsigned long)ncols);
+    return 1;
+  }
+  if (keep_weights && !has_val) {
+    fprintf(stderr, "%s: no val array, writing unweighted\n", inname);
+    keep_weights = 0;
+  }
+
+  const uint64_t *I = words + 3, *J = I + stride;
+  const double *val = (const double *)(J + stride);
+
+  // Count and bucket by row, mirrored entries after the originals so
+  // an explicit (j,i) still wins over the mirror of (i,j).
+  uint64_t *Ap = calloc(nrows + 1, sizeof(*Ap));
+  for (uint64_t k = 0; k < nin; ++k) {
+    if (I[k] >= nrows || J[k] >= ncols) {
+      fprintf(stderr, "%s: entry %lu (%lu, %lu) out of range\n", inname,
+              (unsigned long)k, (unsigned long)I[k], (unsigned long)J[k]);
+      return 1;
+    }
+    ++Ap[I[k]+1];
+    if (symmetrize && I[k] != J[k]) ++Ap[J[k]+1];
+  }
+  for (uint64_t i = 0; i < nrows; ++i) Ap[i+1] += Ap[i];
+
+  uint64_t *fill = malloc(nrows * sizeof(*fill));
+  memcpy(fill, Ap, nrows * sizeof(*fill));
+  struct entry *E = malloc((Ap[nrows] + 1) * sizeof(*E));
+  for (int pass = 0; pass < 1 + symmetrize; ++pass)
+    for (uint64_t k = 0; k < nin; ++k) {
+      uint64_t i = (pass? J[k] : I[k]), j = (pass? I[k] : J[k]);
+      if (pass && i == j) continue;
+      uint64_t p = fill[i]++;
+      E[p].j = j;
+      E[p].seq = p;
+      E[p].x = (keep_weights? val[k] : 1.0);
+    }
+  free(fill);
+  munmap((void *)words, st.st_size);
+
+  // Sort and deduplicate each row in place, compacting as we go.
+  uint64_t nvals = 0;
+  for (uint64_t i = 0; i < nrows; ++i) {
+    uint64_t lo = Ap[i], hi = Ap[i+1];
+    qsort(E + lo, hi - lo, sizeof(*E), entry_cmp);
+    Ap[i] = nvals;
+    for (uint64_t p = lo; p < hi; ++p)
+      if (p == lo || E[p].j != E[p-1].j) E[nvals++] = E[p];
+  }
+  Ap[nrows] = nvals;
+
+  struct csr_header h;
+  memset(&h, 0, sizeof(h));
+  h.magic = CSR_MAGIC;
+  h.version = CSR_VERSION;
+  h.flags = CSR_SORTED | (keep_weights? CSR_WEIGHTED : 0)
+    | (symmetrize? CSR_SYMMETRIC : 0);
+  h.nrows = nrows;
+  h.ncols = ncols;
+  h.nvals = nvals;
+
+  FILE *out = fopen(outname, "wb");
+  if (!out) { perror(outname); return 1; }
+
+  uint32_t crc = 0;
+  write_or_die(out, &h, sizeof(h), &crc);
+  write_or_die(out, Ap, (nrows + 1) * sizeof(*Ap), &crc);
+
+  // Stream the entries out through a bounded staging buffer.
+  enum { CHUNK = 1 << 16 };
+  uint64_t *jbuf = malloc(CHUNK * sizeof(*jbuf));
+  for (uint64_t p = 0; p < nvals; p += CHUNK) {
+    uint64_t n = (nvals - p < CHUNK? nvals - p : CHUNK);
+    for (uint64_t q = 0; q < n; ++q) jbuf[q] = E[p+q].j;
+    write_or_die(out, jbuf, n * sizeof(*jbuf), &crc);
+  }
+  if (keep_weights) {
+    double *xbuf = (double *)jbuf;
+    for (uint64_t p = 0; p < nvals; p += CHUNK) {
+      uint64_t n = (nvals - p < CHUNK? nvals - p : CHUNK);
+      for (uint64_t q = 0; q < n; ++q) xbuf[q] = E[p+q].x;
+      write_or_die(out, xbuf, n * sizeof(*xbuf), &crc);
+    }
+  }
+  free(jbuf);
+
+  h.crc = crc;
+  if (fseek(out, 0, SEEK_SET) != 0 || fwrite(&h, sizeof(h), 1, out) != 1) {
+    perror(outname); return 1;
+  }
+  if (fclose(out) != 0) { perror(outname); return 1; }
+
+  fprintf(stderr, "%s: %lu x %lu, %lu entries in, %lu out, crc %08x\n",
+          outname, (unsigned long)nrows, (unsigned long)ncols,
+          (unsigned long)nin, (unsigned long)nvals, (unsigned)crc);
+
+  free(E);
+  free(Ap);
+  return 0;
+}
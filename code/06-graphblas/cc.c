@@ -0,0 +1,97 @@
+#include <stdlib.h>
+#include <GraphBLAS.h>
+
+#include "graph.h"
+
+// FastSV connected components (Zhang, Azad & Hu, SIAM PP'20) on the
+// undirected view of G, so directed graphs get weak components.  f is
+// the parent forest and gp the grandparents.  Each round hooks trees
+// onto the smallest grandparent seen across an edge (mngp), both
+// stochastically through f[f[u]] and aggressively through f[u], then
+// shortcuts; it stops once no grandparent changes.  Every vertex ends
+// labelled with the smallest id in its component.
+
+// f[f[u]] = min(f[f[u]], mngp[u]).  The index list f has duplicates,
+// which GrB_assign leaves undefined, so this one is a loop.
+static void
+hook_parents(GrB_Vector f, GrB_Vector mngp)
+{
+  int64_t *fx, *mx;
+  GrB_Index fx_size, mx_size, n;
+  bool f_iso, m_iso;
+  GrB_Vector_size(&n, f);
+  GxB_Vector_unpack_Full(f, (void **)&fx, &fx_size, &f_iso, GrB_NULL);
+  GxB_Vector_unpack_Full(mngp, (void **)&mx, &mx_size, &m_iso, GrB_NULL);
+
+  for (GrB_Index u = 0; u < n; ++u) {
+    const int64_t fu = fx[u];
+    if (mx[u] < fx[fu]) fx[fu] = mx[u];
+  }
+
+  GxB_Vector_pack_Full(mngp, (void **)&mx, mx_size, m_iso, GrB_NULL);
+  GxB_Vector_pack_Full(f, (void **)&fx, fx_size, f_iso, GrB_NULL);
+}
+
+static GrB_Index
+count_roots(GrB_Vector f)
+{
+  int64_t *fx;
+  GrB_Index fx_size, n, roots = 0;
+  bool iso;
+  GrB_Vector_size(&n, f);
+  GxB_Vector_unpack_Full(f, (void **)&fx, &fx_size, &iso, GrB_NULL);
+  for (GrB_Index u = 0; u < n; ++u) roots += (fx[u] == (int64_t)u);
+  GxB_Vector_pack_Full(f, (void **)&fx, fx_size, iso, GrB_NULL);
+  return roots;
+}
+
+int cc_fastsv(GrB_Vector *component, GrB_Index *ncomponents, struct graph *G)
+{
+  GrB_Matrix S = graph_symmetric(G);
+  GrB_Index N = graph_nrows(G);
+
+  *ncomponents = N;
+  GrB_Vector_new(component, GrB_INT64, N);
+  if (N == 0) return 0;
+
+  GrB_Vector f = *component, gp, gp_new, mngp, changed;
+  GrB_assign(f, GrB_NULL, GrB_NULL, (int64_t)0, GrB_ALL, N, GrB_NULL);
+  GrB_apply(f, GrB_NULL, GrB_NULL, GrB_ROWINDEX_INT64, f, (int64_t)0, GrB_NULL);
+  GrB_Vector_dup(&gp, f);
+  GrB_Vector_dup(&mngp, f);
+  GrB_Vector_new(&gp_new, GrB_INT64, N);
+  GrB_Vector_new(&changed, GrB_BOOL, N);
+
+  GrB_Index *fidx = malloc(N * sizeof(*fidx));
+
+  int iters = 0;
+  for (bool more = true; more; ++iters) {
+    // mngp[u] = min(mngp[u], min over neighbors v of gp[v])
+    GrB_mxv(mngp, GrB_NULL, GrB_MIN_INT64, GrB_MIN_SECOND_SEMIRING_INT64, S, gp, GrB_NULL);
+
+    hook_parents(f, mngp);
+    GrB_eWiseAdd(f, GrB_NULL, GrB_NULL, GrB_MIN_INT64, f, mngp, GrB_NULL);
+    GrB_eWiseAdd(f, GrB_NULL, GrB_NULL, GrB_MIN_INT64, f, gp, GrB_NULL);
+
+    // gp_new = f[f]
+    GrB_Index n = N;
+    GrB_Vector_extractTuples(GrB_NULL, (int64_t *)fidx, &n, f);
+    GrB_extract(gp_new, GrB_NULL, GrB_NULL, f, fidx, N, GrB_NULL);
+
+    GrB_eWiseMult(changed, GrB_NULL, GrB_NULL, GrB_NE_INT64, gp_new, gp, GrB_NULL);
+    more = false;
+    GrB_reduce(&more, GrB_NULL, GrB_LOR_MONOID_BOOL, changed, GrB_NULL);
+
+    GrB_Vector tmp = gp; gp = gp_new; gp_new = tmp;
+  }
+
+  *ncomponents = count_roots(f);
+
+  free(fidx);
+  GrB_free(&changed);
+  GrB_free(&mngp);
+  GrB_free(&gp_new);
+  GrB_free(&gp);
+
+  return iters;
+}
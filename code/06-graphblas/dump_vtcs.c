@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <GraphBLAS.h>
+
+#include "dump_vtcs.h"
+
+// Entries are streamed from a vector iterator into one large buffer,
+// so no index or value arrays the size of the result are needed.
+
+#define OUTBUF_SIZE (1 << 20)
+#define MAX_RECORD  64
+
+struct outbuf {
+  FILE *f;
+  size_t len;
+  char buf[OUTBUF_SIZE];
+};
+
+static void
+flush_out(struct outbuf *o)
+{
+  if (o->len && fwrite(o->buf, 1, o->len, o->f) != o->len) {
+    perror("Result write error"); abort();
+  }
+  o->len = 0;
+}
+
+static inline char *
+reserve(struct outbuf *o)
+{
+  if (o->len + MAX_RECORD > OUTBUF_SIZE) flush_out(o);
+  return o->buf + o->len;
+}
+
+static inline char *
+put_uint(char *p, uint64_t v)
+{
+  char tmp[20];
+  int n = 0;
+  do { tmp[n++] = '0' + v % 10; v /= 10; } while (v);
+  while (n) *p++ = tmp[--n];
+  return p;
+}
+
+// Scores as d.ddddddddddde[+-]XX with twelve significant digits.
+static const double pow10_tab[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+#define SIG_DIGITS 12
+
+static char *
+put_double(char *p, double x)
+{
+  if (x == 0.0) { memcpy(p, "0", 1); return p + 1; }
+  if (!isfinite(x)) return p + sprintf(p, "%g", x);
+  if (x < 0) { *p++ = '-'; x = -x; }
+
+  int e = (int)floor(log10(x));
+  int shift = SIG_DIGITS - 1 - e;
+  double m;
+  if (shift >= 0 && shift <= 22) m = x * pow10_tab[shift];
+  else if (shift < 0 && shift >= -22) m = x / pow10_tab[-shift];
+  else return p + sprintf(p, "%.*e", SIG_DIGITS - 1, x);
+
+  uint64_t digits = (uint64_t)(m + 0.5);
+  if (digits >= (uint64_t)pow10_tab[SIG_DIGITS]) { digits /= 10; ++e; }
+  else if (digits < (uint64_t)pow10_tab[SIG_DIGITS - 1]) { digits *= 10; --e; }
+
+  char tmp[SIG_DIGITS];
+  for (int k = SIG_DIGITS - 1; k >= 0; --k) { tmp[k] = '0' + digits % 10; digits /= 10; }
+  *p++ = tmp[0];
+  *p++ = '.';
+  memcpy(p, tmp + 1, SIG_DIGITS - 1);
+  p += SIG_DIGITS - 1;
+  *p++ = 'e';
+  *p++ = (e < 0? '-' : '+');
+  if (e < 0) e = -e;
+  if (e < 10) *p++ = '0';
+  return put_uint(p, e);
+}
+
+static const GrB_Index *vtx_map = NULL;
+
+void dump_vtcs_map(const GrB_Index *old_id)
+{
+  vtx_map = old_id;
+}
+
+void dump_vtcs_fmt(const char *fname, GrB_Vector v, enum vtx_format fmt)
+{
+  // Iterators do not typecast, so integer results (BFS levels,
+  // component labels) go through an FP64 copy when values are written.
+  GrB_Vector vd = GrB_NULL;
+  GrB_Type type;
+  GxB_Vector_type(&type, v);
+  if (fmt != VTX_TEXT && type != GrB_FP64) {
+    GrB_Index n;
+    GrB_Vector_size(&n, v);
+    GrB_Vector_new(&vd, GrB_FP64, n);
+    GrB_apply(vd, GrB_NULL, GrB_NULL, GrB_IDENTITY_FP64, v, GrB_NULL);
+    v = vd;
+  }
+
+  struct outbuf *o = malloc(sizeof(*o));
+  o->len = 0;
+  o->f = fopen(fname, (fmt == VTX_BINARY? "wb" : "w"));
+  if (!o->f) { perror("File opening error"); abort(); }
+
+  if (fmt == VTX_BINARY) {
+    GrB_Index nvals;
+    GrB_Vector_nvals(&nvals, v);
+    uint64_t n = nvals;
+    memcpy(reserve(o), &n, sizeof(n));
+    o->len += sizeof(n);
+  }
+
+  GxB_Iterator it;
+  GxB_Iterator_new(&it);
+  GxB_Vector_Iterator_attach(it, v, GrB_NULL);
+  GrB_Info info = GxB_Vector_Iterator_seek(it, 0);
+  while (info != GxB_EXHAUSTED) {
+    uint64_t i = GxB_Vector_Iterator_getIndex(it);
+    if (vtx_map) i = vtx_map[i];
+    char *p = reserve(o);
+    switch (fmt) {
+    case VTX_BINARY: {
+      double x = GxB_Iterator_get_FP64(it);
+      memcpy(p, &i, sizeof(i));
+      memcpy(p + sizeof(i), &x, sizeof(x));
+      p += sizeof(i) + sizeof(x);
+      break;
+    }
+    case VTX_CSV:
+      p = put_uint(p, i);
+      *p++ = ',';
+      p = put_double(p, GxB_Iterator_get_FP64(it));
+      *p++ = '\n';
+      break;
+    default:
+      p = put_uint(p, i);
+      *p++ = '\n';
+    }
+    o->len = p - o->buf;
+    info = GxB_Vector_Iterator_next(it);
+  }
+  GrB_free(&it);
+  GrB_free(&vd);
+
+  flush_out(o);
+  if (fclose(o->f) != 0) { perror("Result write error"); abort(); }
+  free(o);
+}
+
+// Same layouts, for (index, score) pairs already in the order wanted.
+void dump_pairs_fmt(const char *fname, const GrB_Index *idx, const double *val,
+                    GrB_Index n, enum vtx_format fmt)
+{
+  struct outbuf *o = malloc(sizeof(*o));
+  o->len = 0;
+  o->f = fopen(fname, (fmt == VTX_BINARY? "wb" : "w"));
+  if (!o->f) { perror("File opening error"); abort(); }
+
+  if (fmt == VTX_BINARY) {
+    uint64_t count = n;
+    memcpy(reserve(o), &count, sizeof(count));
+    o->len += sizeof(count);
+  }
+
+  for (GrB_Index k = 0; k < n; ++k) {
+    uint64_t i = (vtx_map? vtx_map[idx[k]] : idx[k]);
+    char *p = reserve(o);
+    switch (fmt) {
+    case VTX_BINARY:
+      memcpy(p, &i, sizeof(i));
+      memcpy(p + sizeof(i), &val[k], sizeof(val[k]));
+      p += sizeof(i) + sizeof(val[k]);
+      break;
+    case VTX_CSV:
+      p = put_uint(p, i);
+      *p++ = ',';
+      p = put_double(p, val[k]);
+      *p++ = '\n';
+      break;
+    default:
+      p = put_uint(p, i);
+      *p++ = '\n';
+    }
+    o->len = p - o->buf;
+  }
+
+  flush_out(o);
+  if (fclose(o->f) != 0) { perror("Result write error"); abort(); }
+  free(o);
+}
+
+void dump_vtcs(const char *fname, GrB_Vector v)
+{
+  dump_vtcs_fmt(fname, v, VTX_TEXT);
+}
@@ -0,0 +1,21 @@
+#if !defined(DUMP_VTCS_H)
+#define DUMP_VTCS_H
+
+#include <GraphBLAS.h>
+
+// Output layouts for a result vector:
+//   VTX_TEXT    one vertex index per line
+//   VTX_CSV     "index,score" per line
+//   VTX_BINARY  uint64_t count, then count (uint64_t index, double score)
+enum vtx_format { VTX_TEXT = 0, VTX_CSV, VTX_BINARY };
+
+// With a new -> old vertex map set (e.g. after reordering), indices
+// are written in the original numbering.  NULL turns it off.
+extern void dump_vtcs_map(const GrB_Index *old_id);
+
+extern void dump_vtcs_fmt(const char *fname, GrB_Vector v, enum vtx_format fmt);
+extern void dump_vtcs(const char *fname, GrB_Vector v);
+extern void dump_pairs_fmt(const char *fname, const GrB_Index *idx, const double *val,
+                           GrB_Index n, enum vtx_format fmt);
+
+#endif
@@ -0,0 +1,47 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <GraphBLAS.h>
+
+// GraphBLAS initialization with allocation counting, so kernels can
+// report how many bytes the library allocated during a phase.  Sizes
+// passed to realloc count in full.
+
+static atomic_size_t alloc_bytes = 0;
+static atomic_size_t alloc_calls = 0;
+
+static void *
+count_malloc(size_t n)
+{
+  atomic_fetch_add_explicit(&alloc_bytes, n, memory_order_relaxed);
+  atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+  return malloc(n);
+}
+
+static void *
+count_calloc(size_t n, size_t sz)
+{
+  atomic_fetch_add_explicit(&alloc_bytes, n * sz, memory_order_relaxed);
+  atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+  return calloc(n, sz);
+}
+
+static void *
+count_realloc(void *p, size_t n)
+{
+  atomic_fetch_add_explicit(&alloc_bytes, n, memory_order_relaxed);
+  atomic_fetch_add_explicit(&alloc_calls, 1, memory_order_relaxed);
+  return realloc(p, n);
+}
+
+GrB_Info
+gb_init_counted(GrB_Mode mode)
+{
+  return GxB_init(mode, count_malloc, count_calloc, count_realloc, free);
+}
+
+size_t
+gb_bytes_allocated(size_t *ncalls)
+{
+  if (ncalls) *ncalls = atomic_load(&alloc_calls);
+  return atomic_load(&alloc_bytes);
+}
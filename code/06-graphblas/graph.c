@@ -0,0 +1,128 @@
+#include <GraphBLAS.h>
+
+#include "graph.h"
+
+extern void degree_pseudoinv(GrB_Vector* v, GrB_Matrix A);
+
+static void
+drop_cache(struct graph *G)
+{
+  GrB_free(&G->S);
+  GrB_free(&G->AT);
+  GrB_free(&G->D_pseudoinv);
+  GrB_free(&G->rowsum);
+  GrB_free(&G->outdeg);
+  GrB_Matrix_nrows(&G->nrows, G->A);
+  GrB_Matrix_nvals(&G->nvals, G->A);
+  G->cached_version = G->version;
+}
+
+static inline void
+check_cache(struct graph *G)
+{
+  if (G->cached_version != G->version) drop_cache(G);
+}
+
+void
+graph_init(struct graph *G, GrB_Matrix A)
+{
+  G->A = A;
+  G->version = 0;
+  G->outdeg = GrB_NULL;
+  G->rowsum = GrB_NULL;
+  G->D_pseudoinv = GrB_NULL;
+  G->AT = GrB_NULL;
+  G->S = GrB_NULL;
+  drop_cache(G);
+}
+
+void
+graph_free(struct graph *G)
+{
+  drop_cache(G);
+  GrB_free(&G->A);
+}
+
+void
+graph_touch(struct graph *G)
+{
+  ++G->version;
+}
+
+GrB_Index
+graph_nrows(struct graph *G)
+{
+  check_cache(G);
+  return G->nrows;
+}
+
+GrB_Index
+graph_nvals(struct graph *G)
+{
+  check_cache(G);
+  return G->nvals;
+}
+
+GrB_Vector
+graph_outdeg(struct graph *G)
+{
+  check_cache(G);
+  if (G->outdeg == GrB_NULL) {
+    GrB_Index N = G->nrows;
+    GrB_Vector ones;
+    GrB_Vector_new(&ones, GrB_INT64, N);
+    GrB_assign(ones, GrB_NULL, GrB_NULL, 1, GrB_ALL, N, GrB_NULL);
+    GrB_Vector_new(&G->outdeg, GrB_INT64, N);
+    GrB_mxv(G->outdeg, GrB_NULL, GrB_NULL, GxB_PLUS_PAIR_INT64, G->A, ones, GrB_NULL);
+    GrB_free(&ones);
+  }
+  return G->outdeg;
+}
+
+GrB_Vector
+graph_rowsum(struct graph *G)
+{
+  check_cache(G);
+  if (G->rowsum == GrB_NULL) {
+    GrB_Vector_new(&G->rowsum, GrB_FP64, G->nrows);
+    GrB_reduce(G->rowsum, GrB_NULL, GrB_NULL, GrB_PLUS_MONOID_FP64, G->A, GrB_NULL);
+    GrB_select(G->rowsum, GrB_NULL, GrB_NULL, GrB_VALUENE_FP64, G->rowsum, 0.0, GrB_NULL);
+  }
+  return G->rowsum;
+}
+
+GrB_Vector
+graph_degree_pseudoinv(struct graph *G)
+{
+  check_cache(G);
+  if (G->D_pseudoinv == GrB_NULL)
+    degree_pseudoinv(&G->D_pseudoinv, G->A);
+  return G->D_pseudoinv;
+}
+
+GrB_Matrix
+graph_transpose(struct graph *G)
+{
+  check_cache(G);
+  if (G->AT == GrB_NULL) {
+    GrB_Type type;
+    GxB_Matrix_type(&type, G->A);
+    GrB_Matrix_new(&G->AT, type, G->nrows, G->nrows);
+    GrB_transpose(G->AT, GrB_NULL, GrB_NULL, G->A, GrB_NULL);
+  }
+  return G->AT;
+}
+
+// The undirected view components and triangle counting work on.
+// Self-loops are dropped; they join nothing and close no triangles.
+GrB_Matrix
+graph_symmetric(struct graph *G)
+{
+  check_cache(G);
+  if (G->S == GrB_NULL) {
+    GrB_Matrix_new(&G->S, GrB_BOOL, G->nrows, G->nrows);
+    GrB_eWiseAdd(G->S, GrB_NULL, GrB_NULL, GrB_ONEB_BOOL, G->A, graph_transpose(G), GrB_NULL);
+    GrB_select(G->S, GrB_NULL, GrB_NULL, GrB_OFFDIAG, G->S, 0, GrB_NULL);
+  }
+  return G->S;
+}
@@ -0,0 +1,36 @@
+#if !defined(GRAPH_H)
+#define GRAPH_H
+
+#include <stdint.h>
+#include <GraphBLAS.h>
+
+// A loaded graph plus the derived data the kernels keep asking for.
+// Everything but A is computed on first use and cached.  Anything that
+// modifies A must call graph_touch() so stale entries are rebuilt.
+struct graph {
+  GrB_Matrix A;
+  uint64_t version;
+
+  uint64_t cached_version;
+  GrB_Index nrows, nvals;
+  GrB_Vector outdeg;       // INT64 count of stored entries per row
+  GrB_Vector rowsum;       // FP64 row sums, zero rows dropped
+  GrB_Vector D_pseudoinv;  // 1 / rowsum
+  GrB_Matrix AT;
+  GrB_Matrix S;            // BOOL pattern of A + A', no diagonal
+};
+
+// Takes ownership of A; graph_free() releases it.
+extern void graph_init(struct graph *G, GrB_Matrix A);
+extern void graph_free(struct graph *G);
+extern void graph_touch(struct graph *G);
+
+extern GrB_Index graph_nrows(struct graph *G);
+extern GrB_Index graph_nvals(struct graph *G);
+extern GrB_Vector graph_outdeg(struct graph *G);
+extern GrB_Vector graph_rowsum(struct graph *G);
+extern GrB_Vector graph_degree_pseudoinv(struct graph *G);
+extern GrB_Matrix graph_transpose(struct graph *G);
+extern GrB_Matrix graph_symmetric(struct graph *G);
+
+#endif
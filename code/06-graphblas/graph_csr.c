@@ -0,0 +1,42 @@
+#include "graph_csr.h"
+
+// Table-driven CRC-32 (the zlib polynomial), eight bytes per step.
+
+static uint32_t crc_table[8][256];
+static int crc_table_ready = 0;
+
+static void
+crc_table_init(void)
+{
+  for (uint32_t k = 0; k < 256; ++k) {
+    uint32_t c = k;
+    for (int b = 0; b < 8; ++b)
+      c = (c & 1? 0xEDB88320u ^ (c >> 1) : c >> 1);
+    crc_table[0][k] = c;
+  }
+  for (uint32_t k = 0; k < 256; ++k)
+    for (int t = 1; t < 8; ++t)
+      crc_table[t][k] = (crc_table[t-1][k] >> 8)
+        ^ crc_table[0][crc_table[t-1][k] & 0xFF];
+  crc_table_ready = 1;
+}
+
+uint32_t
+csr_crc32(uint32_t crc, const void *buf, size_t len)
+{
+  if (!crc_table_ready) crc_table_init();
+
+  const unsigned char *p = buf;
+  crc = ~crc;
+  for (; len >= 8; len -= 8, p += 8) {
+    uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8
+                         | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+    crc = crc_table[7][lo & 0xFF] ^ crc_table[6][(lo >> 8) & 0xFF]
+      ^ crc_table[5][(lo >> 16) & 0xFF] ^ crc_table[4][lo >> 24]
+      ^ crc_table[3][p[4]] ^ crc_table[2][p[5]]
+      ^ crc_table[1][p[6]] ^ crc_table[0][p[7]];
+  }
+  while (len--)
+    crc = crc_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
@@ -0,0 +1,61 @@
+#if !defined(GRAPH_CSR_H)
+#define GRAPH_CSR_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// On-disk CSR graph format.  The file is a csr_header followed by
+//
+//   uint64_t Ap[nrows+1];   row pointers, Ap[0] == 0, Ap[nrows] == nvals
+//   uint64_t Aj[nvals];     column indices, unique within each row
+//   double   Ax[nvals];     only when CSR_WEIGHTED is set
+//
+// all in host byte order.  The crc covers the header (with crc set to
+// zero) followed by the payload, so a truncated or damaged file is
+// caught before it reaches GraphBLAS.
+
+#define CSR_MAGIC   UINT64_C(0x015253432D427247)  // "GrB-CSR\1"
+#define CSR_VERSION 1
+
+#define CSR_WEIGHTED  0x1u  // Ax is present
+#define CSR_SYMMETRIC 0x2u  // both triangles are stored and match
+#define CSR_SORTED    0x4u  // column indices ascend within each row
+
+struct csr_header {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t flags;
+  uint64_t nrows;
+  uint64_t ncols;
+  uint64_t nvals;
+  uint32_t crc;
+  uint32_t reserved;
+};
+
+static inline size_t
+csr_payload_bytes(const struct csr_header *h)
+{
+  size_t n = (h->nrows + 1 + h->nvals) * sizeof(uint64_t);
+  if (h->flags & CSR_WEIGHTED) n += h->nvals * sizeof(double);
+  return n;
+}
+
+// The older dump is three words (nrows, ncols, nvals) then I, J and an
+// optional val array.  Some dumps were written with arrays sized for
+// more entries than the header's nvals, so derive the array stride
+// from the file length.  Returns 0 if the file is too short.
+static inline uint64_t
+dump_stride(uint64_t nwords, uint64_t nvals, int *has_val)
+{
+  uint64_t avail = (nwords >= 3? nwords - 3 : 0);
+  *has_val = 0;
+  if (avail == 2 * nvals) return nvals;
+  if (avail % 3 == 0 && avail / 3 >= nvals) { *has_val = 1; return avail / 3; }
+  if (avail >= 3 * nvals) { *has_val = 1; return nvals; }
+  if (avail >= 2 * nvals) return nvals;
+  return 0;
+}
+
+extern uint32_t csr_crc32(uint32_t crc, const void *buf, size_t len);
+
+#endif
@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <GraphBLAS.h>
+
+#include "graph.h"
+#include "reorder.h"
+
+// Relabel G's vertices with the chosen ordering, replacing A by
+// A(perm, perm).  *old_id receives the malloc'd new -> old map so
+// results can still be reported in the input's numbering.
+void
+graph_reorder(GrB_Index **old_id, struct graph *G, enum reorder_method m)
+{
+  GrB_Matrix A = G->A, C;
+  GrB_Index n = graph_nrows(G), ncols;
+  GrB_Matrix_ncols(&ncols, A);
+  if (ncols != n) { fprintf(stderr, "Reordering needs a square matrix\n"); abort(); }
+
+  GrB_Index *perm = malloc(n * sizeof(*perm));
+  if (!perm) { perror("Cannot allocate permutation"); abort(); }
+
+  // Borrow A's CSR arrays for the ordering and hand them straight back.
+  GrB_Index *Ap, *Aj, Ap_size, Aj_size, Ax_size;
+  void *Ax;
+  bool iso, jumbled;
+  GxB_Matrix_unpack_CSR(A, &Ap, &Aj, &Ax, &Ap_size, &Aj_size, &Ax_size,
+                        &iso, &jumbled, GrB_NULL);
+  reorder_perm(perm, Ap, Aj, n, m);
+  GxB_Matrix_pack_CSR(A, &Ap, &Aj, &Ax, Ap_size, Aj_size, Ax_size,
+                      iso, jumbled, GrB_NULL);
+
+  GrB_Type type;
+  GxB_Matrix_type(&type, A);
+  GrB_Matrix_new(&C, type, n, n);
+  GrB_Matrix_extract(C, GrB_NULL, GrB_NULL, A, perm, n, perm, n, GrB_NULL);
+
+  GrB_free(&G->A);
+  G->A = C;
+  graph_touch(G);
+
+  *old_id = perm;
+}
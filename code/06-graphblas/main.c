@@ -1,85 +1,408 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <assert.h>
 
 #include <GraphBLAS.h>
 
+#include "graph.h"
+#include "dump_vtcs.h"
+#include "pr_delta.h"
+#include "region.h"
+#include "reorder.h"
+
 extern int bfs(GrB_Vector *level,
-               GrB_Matrix A, GrB_Index source,
+               struct graph *G, GrB_Index source,
                const GrB_Index max_level);
 extern int pagerank(GrB_Vector *pr,
-                    GrB_Matrix A, GrB_Vector v,
+                    struct graph *G, GrB_Vector v,
                     const double alpha, const double ctol, const int itmax);
+extern int pagerank_push(GrB_Vector *pr,
+                         struct graph *G, GrB_Vector v,
+                         const double alpha, const double ctol, const int itmax);
+
+extern int cc_fastsv(GrB_Vector *component, GrB_Index *ncomponents, struct graph *G);
+extern int64_t triangle_count(struct graph *G);
+
+extern int pagerank_trace;
+extern enum pr_norm pagerank_norm;
 
+extern GrB_Info gb_init_counted(GrB_Mode mode);
 extern void read_dumped(GrB_Matrix *A, const char *fname);
-extern void dump_vtcs(const char *fname, GrB_Vector v);
+extern void graph_reorder(GrB_Index **old_id, struct graph *G, enum reorder_method m);
+extern GrB_Index topk_pr(GrB_Index *idx, double *val, GrB_Index k, GrB_Vector pr);
 static void filter_pr(GrB_Vector *filtered_pr, GrB_Vector pr, double thresh);
 
-int
-main (int argc, char** argv)
+enum run_mode { RUN_FULL, RUN_BFS, RUN_PAGERANK, RUN_CC, RUN_TC };
+
+enum phase { PH_LOAD, PH_BFS, PH_PAGERANK, PH_CC, PH_TC, PH_FILTER, PH_PRINT, PH_DUMP, NPHASES };
+static const char *phase_name[NPHASES] = { "load", "bfs", "pagerank", "cc", "tc", "filter", "print", "dump" };
+
+struct options {
+  const char *graph;
+  const char *out;
+  const char *json;
+  const char *map;
+  enum reorder_method reorder;
+  enum run_mode mode;
+  int use_push;
+  enum vtx_format format;
+  long seed;          // -1: N-1
+  GrB_Index depth;
+  GrB_Index n_seeds;
+  double alpha, tol, thresh;
+  int itmax;
+  GrB_Index topk;
+  int repeat;
+  long rng;
+};
+
+static void
+usage(const char *prog)
 {
-  srand48(11 * 0xDEADBEEF);
+  fprintf(stderr,
+          "Usage: %s [options] graph.bin\n"
+          "  -m MODE    full (bfs, seeds, pagerank), bfs, pagerank,\n"
+          "             cc (connected components) or tc (triangles) [full]\n"
+          "  -P ALG     pagerank algorithm: power or push [power]\n"
+          "  -s VTX     bfs source vertex [N-1]\n"
+          "  -d DEPTH   bfs depth [3]\n"
+          "  -n COUNT   pagerank seeds drawn from the bfs region [3]\n"
+          "  -a ALPHA   damping factor [0.85]\n"
+          "  -t TOL     convergence tolerance [1e-4]\n"
+          "  -e NORM    norm for the tolerance: linf, l1 or l2 [linf]\n"
+          "  -i ITERS   maximum pagerank iterations [100]\n"
+          "  -T THRESH  keep scores >= THRESH [1e-3]\n"
+          "  -k K       keep the K best scores instead of thresholding\n"
+          "  -o FILE    output file [out-list]\n"
+          "  -f FMT     output format: text, csv or binary [text]\n"
+          "  -r COUNT   repeat everything after loading COUNT times [1]\n"
+          "  -R SEED    random seed for seed selection\n"
+          "  -O ORDER   relabel vertices: degree, rcm or gorder\n"
+          "  -M FILE    new -> old vertex map from reorder_bin (graph.bin.perm)\n"
+          "  -j FILE    append per-region JSON lines to FILE (- for stdout)\n"
+          "  -v         trace each pagerank iteration\n"
+          "In pagerank mode the teleport vector is the source vertex alone.\n"
+          "Vertex ids on the command line and in output are the original ones.\n",
+          prog);
+  exit(1);
+}
 
-  GrB_Info info;
-  GrB_init(GrB_BLOCKING);
+static void
+parse_options(struct options *o, int argc, char **argv)
+{
+  o->out = "out-list";
+  o->json = NULL;
+  o->map = NULL;
+  o->reorder = REORDER_NONE;
+  o->mode = RUN_FULL;
+  o->use_push = 0;
+  o->format = VTX_TEXT;
+  o->seed = -1;
+  o->depth = 3;
+  o->n_seeds = 3;
+  o->alpha = 0.85;
+  o->tol = 1.0e-4;
+  o->thresh = 1.0e-3;
+  o->itmax = 100;
+  o->topk = 0;
+  o->repeat = 1;
+  o->rng = 11 * 0xDEADBEEF;
 
-  GrB_Matrix A;
-  read_dumped(&A, argv[1]);
-  
-  GrB_Index N;
-  info = GrB_Matrix_nrows(&N, A);
-  assert(info == GrB_SUCCESS);
+  int c;
+  while ((c = getopt(argc, argv, "m:P:s:d:n:a:t:e:i:T:k:o:f:r:R:O:M:j:v")) != -1) {
+    switch (c) {
+    case 'm':
+      if (!strcmp(optarg, "full")) o->mode = RUN_FULL;
+      else if (!strcmp(optarg, "bfs")) o->mode = RUN_BFS;
+      else if (!strcmp(optarg, "pagerank")) o->mode = RUN_PAGERANK;
+      else if (!strcmp(optarg, "cc")) o->mode = RUN_CC;
+      else if (!strcmp(optarg, "tc")) o->mode = RUN_TC;
+      else usage(argv[0]);
+      break;
+    case 'P':
+      if (!strcmp(optarg, "power")) o->use_push = 0;
+      else if (!strcmp(optarg, "push")) o->use_push = 1;
+      else usage(argv[0]);
+      break;
+    case 's': o->seed = atol(optarg); break;
+    case 'd': o->depth = atol(optarg); break;
+    case 'n': o->n_seeds = atol(optarg); break;
+    case 'a': o->alpha = atof(optarg); break;
+    case 't': o->tol = atof(optarg); break;
+    case 'e':
+      if (!strcmp(optarg, "linf")) pagerank_norm = PR_NORM_LINF;
+      else if (!strcmp(optarg, "l1")) pagerank_norm = PR_NORM_L1;
+      else if (!strcmp(optarg, "l2")) pagerank_norm = PR_NORM_L2;
+      else usage(argv[0]);
+      break;
+    case 'i': o->itmax = atoi(optarg); break;
+    case 'T': o->thresh = atof(optarg); break;
+    case 'k': o->topk = atol(optarg); break;
+    case 'o': o->out = optarg; break;
+    case 'f':
+      if (!strcmp(optarg, "text")) o->format = VTX_TEXT;
+      else if (!strcmp(optarg, "csv")) o->format = VTX_CSV;
+      else if (!strcmp(optarg, "binary")) o->format = VTX_BINARY;
+      else usage(argv[0]);
+      break;
+    case 'r': o->repeat = atoi(optarg); break;
+    case 'R': o->rng = atol(optarg); break;
+    case 'O': if (reorder_parse(&o->reorder, optarg)) usage(argv[0]); break;
+    case 'M': o->map = optarg; break;
+    case 'j': o->json = optarg; break;
+    case 'v': pagerank_trace = 1; break;
+    default: usage(argv[0]);
+    }
+  }
+  if (optind >= argc || o->repeat < 1) usage(argv[0]);
+  o->graph = argv[optind];
+}
 
-  GrB_Index seed = N-1; // Kinda works for most pre-cooked graphs.
+// New -> old vertex ids when the graph has been relabelled.
+static GrB_Index *old_id = NULL;
 
-  GrB_Vector region;
+static inline long
+label(GrB_Index v)
+{
+  return (long)(old_id? old_id[v] : v);
+}
 
-  bfs(&region, A, seed, 3);
+static GrB_Index *
+read_map(const char *fname, GrB_Index N)
+{
+  FILE *f = fopen(fname, "rb");
+  if (!f) { perror(fname); abort(); }
+  uint64_t n;
+  GrB_Index *map = NULL;
+  if (fread(&n, sizeof(n), 1, f) != 1 || n != N
+      || !(map = malloc(n * sizeof(*map)))
+      || fread(map, sizeof(*map), n, f) != n) {
+    fprintf(stderr, "%s: not a vertex map for %ld vertices\n", fname, (long)N);
+    abort();
+  }
+  fclose(f);
+  return map;
+}
 
+// Draw up to n_seeds vertices from a BFS region as teleport targets.
+static void
+pick_seeds(GrB_Vector pr_seeds, GrB_Vector region, GrB_Index n_seeds, int verbose)
+{
   GrB_Index region_size;
   GrB_Vector_nvals(&region_size, region);
 
-  GrB_Index *region_vtx = malloc(region_size * sizeof(GrB_Index));
-  int64_t *levels = malloc(region_size * sizeof(int64_t));
-  GrB_Vector_extractTuples(region_vtx, levels, &region_size, region);
-
-  free(levels);
-  GrB_free(&region);
+  GrB_Index *region_vtx = malloc((region_size + 1) * sizeof(GrB_Index));
+  GrB_Vector_extractTuples(region_vtx, (int64_t *)NULL, &region_size, region);
 
-  GrB_Vector pr_seeds;
-  GrB_Vector_new(&pr_seeds, GrB_FP64, N);
-
-  GrB_Index n_seeds = (region_size >= 3? 3 : region_size);
+  if (n_seeds > region_size) n_seeds = region_size;
 
   for (GrB_Index k = 0; k < n_seeds; ++k) {
     const GrB_Index i = lrand48() % region_size;
     GrB_Index vtx_of_interest = region_vtx[i];
     GrB_Vector_setElement(pr_seeds, 1.0 / n_seeds, vtx_of_interest);
-    printf("Seed %ld: %ld\n", (long)k, (long)vtx_of_interest);
+    if (verbose) printf("Seed %ld: %ld\n", (long)k, label(vtx_of_interest));
   }
 
   free(region_vtx);
+}
 
-  GrB_Vector pr;
-  pagerank(&pr, A, pr_seeds, 0.85, 1.0e-4, 100);
+// Components and triangles work on the undirected view of the graph.
+static void
+run_undirected(const struct options *o, struct graph *G, double *t, int last)
+{
+  if (o->mode == RUN_CC) {
+    GrB_Vector component;
+    GrB_Index ncomp;
+    region_begin("cc");
+    int iters = cc_fastsv(&component, &ncomp, G);
+    t[PH_CC] = region_end(ncomp);
+    if (last) printf("Components: %ld (%d iterations)\n", (long)ncomp, iters);
+    // Written as "vertex,label".  Vertices are mapped back to original
+    // ids but labels are not, so only compare labels with each other.
+    region_begin("dump");
+    dump_vtcs_fmt(o->out, component, (o->format == VTX_TEXT? VTX_CSV : o->format));
+    t[PH_DUMP] = region_end(graph_nrows(G));
+    GrB_free(&component);
+  } else if (o->mode == RUN_TC) {
+    region_begin("tc");
+    int64_t ntri = triangle_count(G);
+    t[PH_TC] = region_end(ntri);
+    if (last) printf("Triangles: %ld\n", (long)ntri);
+  }
+}
 
-  // Really, you'd filter for a statistical difference,
-  // possibly against global PageRank.
-  GrB_Vector filtered_pr;
-  filter_pr(&filtered_pr, pr, 1.0e-3);
+// BFS around the source, then PageRank seeded from that region.
+static void
+run_pipeline(const struct options *o, struct graph *G, GrB_Index seed,
+             double *t, int last)
+{
+  GrB_Index N = graph_nrows(G), nnz;
 
-  // SuiteSparse GraphBLAS extension, but LGB also supports:
-  GxB_print(pr, GxB_SUMMARY);
-  GxB_print(filtered_pr, GxB_COMPLETE);
+  GrB_Vector pr_seeds;
+  GrB_Vector_new(&pr_seeds, GrB_FP64, N);
 
-  dump_vtcs("out-list", filtered_pr);
+  if (o->mode != RUN_PAGERANK) {
+    region_begin("bfs");
+    GrB_Vector region;
+    int depth = bfs(&region, G, seed, o->depth);
+    if (o->mode == RUN_FULL) pick_seeds(pr_seeds, region, o->n_seeds, last);
+    GrB_Vector_nvals(&nnz, region);
+    t[PH_BFS] = region_end(nnz);
 
-  GrB_free(&filtered_pr);
-  GrB_free(&pr);
+    if (o->mode == RUN_BFS) {
+      if (last) {
+        region_begin("print");
+        printf("BFS from %ld: %d levels\n", label(seed), depth);
+        GxB_print(region, GxB_SUMMARY);
+        t[PH_PRINT] = region_end(-1);
+      }
+      region_begin("dump");
+      dump_vtcs_fmt(o->out, region, o->format);
+      t[PH_DUMP] = region_end(nnz);
+    }
+    GrB_free(&region);
+  } else {
+    GrB_Vector_setElement(pr_seeds, 1.0, seed);
+  }
+
+  if (o->mode != RUN_BFS) {
+    region_begin("pagerank");
+    GrB_Vector pr;
+    int iters;
+    if (o->use_push)
+      iters = pagerank_push(&pr, G, pr_seeds, o->alpha, o->tol, o->itmax);
+    else
+      iters = pagerank(&pr, G, pr_seeds, o->alpha, o->tol, o->itmax);
+    GrB_Vector_nvals(&nnz, pr);
+    t[PH_PAGERANK] = region_end(nnz);
+
+    if (last) {
+      region_begin("print");
+      printf("PageRank: %d iterations\n", iters);
+      // SuiteSparse GraphBLAS extension, but LGB also supports:
+      GxB_print(pr, GxB_SUMMARY);
+      t[PH_PRINT] = region_end(-1);
+    }
+
+    if (o->topk > 0) {
+      region_begin("filter");
+      GrB_Index *top_vtx = malloc(o->topk * sizeof(*top_vtx));
+      double *top_score = malloc(o->topk * sizeof(*top_score));
+      GrB_Index ntop = topk_pr(top_vtx, top_score, o->topk, pr);
+      t[PH_FILTER] = region_end(ntop);
+      if (last)
+        for (GrB_Index k = 0; k < ntop; ++k)
+          printf("Top %ld: %ld %g\n", (long)k, label(top_vtx[k]), top_score[k]);
+      // Written in rank order.
+      region_begin("dump");
+      dump_pairs_fmt(o->out, top_vtx, top_score, ntop, o->format);
+      t[PH_DUMP] = region_end(ntop);
+      free(top_score);
+      free(top_vtx);
+    } else {
+      // Really, you'd filter for a statistical difference,
+      // possibly against global PageRank.
+      region_begin("filter");
+      GrB_Vector filtered_pr;
+      filter_pr(&filtered_pr, pr, o->thresh);
+      GrB_Vector_nvals(&nnz, filtered_pr);
+      t[PH_FILTER] = region_end(nnz);
+      if (last) {
+        region_begin("print");
+        GxB_print(filtered_pr, GxB_COMPLETE);
+        t[PH_PRINT] += region_end(-1);
+      }
+      region_begin("dump");
+      dump_vtcs_fmt(o->out, filtered_pr, o->format);
+      t[PH_DUMP] = region_end(nnz);
+      GrB_free(&filtered_pr);
+    }
+    GrB_free(&pr);
+  }
   GrB_free(&pr_seeds);
-  GrB_free(&A);
+}
+
+int
+main (int argc, char** argv)
+{
+  struct options opt;
+  parse_options(&opt, argc, argv);
+
+  srand48(opt.rng);
+
+  if (opt.json) {
+    FILE *jf = (strcmp(opt.json, "-")? fopen(opt.json, "a") : stdout);
+    if (!jf) { perror("Error opening JSON output"); abort(); }
+    region_output(jf);
+  }
+
+  GrB_Info info;
+  gb_init_counted(GrB_BLOCKING);
+
+  double t[NPHASES];
+
+  GrB_Matrix A;
+  GrB_Index nnz;
+  region_begin("load");
+  read_dumped(&A, opt.graph);
+  GrB_Matrix_nvals(&nnz, A);
+  t[PH_LOAD] = region_end(nnz);
+
+  // G owns A from here on.
+  struct graph G;
+  graph_init(&G, A);
+
+  GrB_Index N;
+  info = GrB_Matrix_nrows(&N, A);
+  assert(info == GrB_SUCCESS);
+
+  if (opt.map) old_id = read_map(opt.map, N);
+  if (opt.reorder != REORDER_NONE) {
+    GrB_Index *perm;
+    region_begin("reorder");
+    graph_reorder(&perm, &G, opt.reorder);
+    region_end(graph_nvals(&G));
+    // Compose with a map the file already came with.
+    if (old_id) {
+      for (GrB_Index k = 0; k < N; ++k) perm[k] = old_id[perm[k]];
+      free(old_id);
+    }
+    old_id = perm;
+  }
+  dump_vtcs_map(old_id);
+
+  // Kinda works for most pre-cooked graphs.
+  GrB_Index seed = (opt.seed >= 0? (GrB_Index)opt.seed : N-1);
+  if (seed >= N) { fprintf(stderr, "Source %ld out of range\n", opt.seed); return 1; }
+  if (old_id) {
+    GrB_Index k = 0;
+    while (old_id[k] != seed) ++k;
+    seed = k;
+  }
+
+  for (int run = 0; run < opt.repeat; ++run) {
+    const int last = (run == opt.repeat - 1);
+    for (int p = PH_BFS; p < NPHASES; ++p) t[p] = 0.0;
+    region_set_run(run);
+
+    if (opt.mode == RUN_CC || opt.mode == RUN_TC)
+      run_undirected(&opt, &G, t, last);
+    else
+      run_pipeline(&opt, &G, seed, t, last);
+
+    // The load happens once; later runs report it as zero.
+    fprintf(stderr, "run %d:", run);
+    for (int p = 0; p < NPHASES; ++p)
+      fprintf(stderr, " %s %.3f ms", phase_name[p], (run == 0 || p != PH_LOAD? t[p] : 0.0));
+    fprintf(stderr, "\n");
+  }
+
+  graph_free(&G);
+  free(old_id);
 }
 
 void
@@ -92,7 +415,7 @@ filter_pr(GrB_Vector *filtered_pr, GrB_Vector pr, double thresh)
 
   GrB_Vector_dup(filtered_pr, pr);
   GrB_Vector_clear(*filtered_pr);
-  
+
   GxB_select(*filtered_pr, GrB_NULL, GrB_NULL, GxB_GE_THUNK, pr, tmp, GrB_NULL);
   GrB_free(&tmp);
 }
@@ -1,53 +1,260 @@
-/* 
-*   Matrix Market I/O example program
+/*
+*   Matrix Market to .bin converter
 *
-*   Read a real (non-complex) sparse matrix from a Matrix Market (v. 2.0) file.
-*   and copies it to stdout.  This porgram does nothing useful, but
-*   illustrates common usage of the Matrix Matrix I/O routines.
-*   (See http://math.nist.gov/MatrixMarket for details.)
+*   Reads a sparse (coordinate) Matrix Market file and writes the raw
+*   triple dump that read_dumped() consumes: three uint64_t words
+*   (nrows, ncols, nvals) followed by the I, J and val arrays.
+*   (See http://math.nist.gov/MatrixMarket for the file format.)
 *
-*   Usage:  a.out [filename] > output
+*   Usage:  mmio [-t nthreads] [-l] [martix-market-filename] [out.bin]
+*
+*       -t  number of parser threads (default: online CPUs)
+*       -l  keep only the stored triangle of symmetric matrices
 *
-*       
 *   NOTES:
 *
 *   1) Matrix Market files are always 1-based, i.e. the index of the first
-*      element of a matrix is (1,1), not (0,0) as in C.  ADJUST THESE
-*      OFFSETS ACCORDINGLY offsets accordingly when reading and writing 
-*      to files.
+*      element of a matrix is (1,1), not (0,0) as in C.  The dump is
+*      0-based.
+*
+*   2) The banner and size line are read with the mmio routines.  The
+*      entries are parsed in parallel from a mapping of the file: it is
+*      split into one chunk per thread at line boundaries, each thread
+*      counts its entries, and after a prefix sum every thread parses
+*      directly into its slice of the shared I, J and val arrays.
 *
-*   2) ANSI C requires one to use the "l" format modifier when reading
-*      double precision floating point numbers in scanf() and
-*      its variants.  For example, use "%lf", "%lg", or "%le"
-*      when reading doubles, otherwise errors will occur.
+*   3) pattern files get val = 1.0, integer files are stored as doubles.
+*      symmetric and skew-symmetric files are expanded to both triangles
+*      unless -l is given, with the mirror of a skew entry negated.
 */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
-#include <assert.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <GraphBLAS.h>
 #include "mmio.h"
 
+struct parse_job {
+    int id;
+    const char *begin, *end;    /* [begin, end) holds whole lines */
+    GrB_Index count;            /* entries in this chunk */
+    GrB_Index offset;           /* first slot in I, J, val */
+    GrB_Index offdiag;          /* entries to mirror */
+    GrB_Index mirror_offset;    /* first slot for the mirrored copies */
+    GrB_Index bad_line;         /* 0 or chunk-relative line of an error */
+};
+
+static struct {
+    int nthreads;
+    int pattern, expand, skew;
+    GrB_Index M, N, nz;
+    GrB_Index *I, *J;
+    double *val;
+    struct parse_job *jobs;
+    pthread_barrier_t barrier;
+} P;
+
+static const double pow10_exact[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline int is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static inline const char *
+skip_blanks(const char *p, const char *end)
+{
+    while (p < end && is_blank(*p)) ++p;
+    return p;
+}
+
+static inline const char *
+parse_index(const char *p, const char *end, GrB_Index *out)
+{
+    GrB_Index v = 0;
+    const char *s = p;
+    while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+    if (p == s) return NULL;
+    *out = v;
+    return p;
+}
+
+/* Fast path for numbers with at most 19 significant digits and a
+   small decimal exponent, where mantissa * 10^e rounds once and is
+   exact.  Anything else falls back to strtod. */
+static const char *
+parse_double(const char *p, const char *end, double *out)
+{
+    const char *s = p;
+    int neg = 0;
+    if (p < end && (*p == '-' || *p == '+')) neg = (*p++ == '-');
+
+    uint64_t mant = 0;
+    int digits = 0, exp10 = 0, any = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (digits < 19) { mant = mant * 10 + (*p - '0'); if (mant) ++digits; }
+        else ++exp10;
+        ++p; any = 1;
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (digits < 19) { mant = mant * 10 + (*p - '0'); if (mant) ++digits; --exp10; }
+            ++p; any = 1;
+        }
+    }
+    if (!any) return NULL;
+    if (p < end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D')) {
+        const char *q = p + 1;
+        int eneg = 0, e = 0, edig = 0;
+        if (q < end && (*q == '-' || *q == '+')) eneg = (*q++ == '-');
+        while (q < end && *q >= '0' && *q <= '9') {
+            if (e < 100000) e = e * 10 + (*q - '0');
+            ++q; ++edig;
+        }
+        if (edig) { exp10 += (eneg? -e : e); p = q; }
+    }
+
+    if (digits < 19 && mant < (UINT64_C(1) << 53) && exp10 >= -22 && exp10 <= 22) {
+        double v = (double)mant;
+        v = (exp10 < 0? v / pow10_exact[-exp10] : v * pow10_exact[exp10]);
+        *out = (neg? -v : v);
+        return p;
+    }
+
+    char buf[128];
+    size_t len = p - s;
+    if (len >= sizeof(buf)) len = sizeof(buf) - 1;
+    memcpy(buf, s, len);
+    buf[len] = '\0';
+    for (size_t k = 0; k < len; ++k) if (buf[k] == 'd' || buf[k] == 'D') buf[k] = 'e';
+    *out = strtod(buf, NULL);
+    return p;
+}
+
+static inline int
+line_has_entry(const char *p, const char *eol)
+{
+    p = skip_blanks(p, eol);
+    return p < eol && *p != '%';
+}
+
+static void *
+parse_chunk(void *arg)
+{
+    struct parse_job *job = arg;
+    const char *p, *eol;
+
+    /* Pass 1: count the entries in this chunk. */
+    GrB_Index count = 0;
+    for (p = job->begin; p < job->end; p = eol + 1) {
+        eol = memchr(p, '\n', job->end - p);
+        if (!eol) eol = job->end;
+        count += line_has_entry(p, eol);
+    }
+    job->count = count;
+
+    pthread_barrier_wait(&P.barrier);
+    if (job->id == 0) {
+        GrB_Index off = 0;
+        for (int t = 0; t < P.nthreads; ++t) {
+            P.jobs[t].offset = off;
+            off += P.jobs[t].count;
+        }
+    }
+    pthread_barrier_wait(&P.barrier);
+
+    /* Pass 2: parse into this chunk's slice. */
+    GrB_Index k = job->offset, line = 0, offdiag = 0;
+    GrB_Index limit = (job->offset + count <= P.nz? job->offset + count : P.nz);
+    for (p = job->begin; p < job->end && k < limit; p = eol + 1) {
+        eol = memchr(p, '\n', job->end - p);
+        if (!eol) eol = job->end;
+        ++line;
+        if (!line_has_entry(p, eol)) continue;
+
+        GrB_Index i, j;
+        double v = 1.0;
+        const char *q = skip_blanks(p, eol);
+        q = parse_index(q, eol, &i);
+        if (q) q = parse_index(skip_blanks(q, eol), eol, &j);
+        if (q && !P.pattern) q = parse_double(skip_blanks(q, eol), eol, &v);
+        if (!q || i < 1 || j < 1 || i > P.M || j > P.N) {
+            job->bad_line = line;
+            break;
+        }
+        P.I[k] = i - 1;
+        P.J[k] = j - 1;
+        P.val[k] = v;
+        offdiag += (i != j);
+        ++k;
+    }
+    job->offdiag = offdiag;
+
+    if (!P.expand) return NULL;
+
+    pthread_barrier_wait(&P.barrier);
+    if (job->id == 0) {
+        GrB_Index off = P.nz;
+        for (int t = 0; t < P.nthreads; ++t) {
+            P.jobs[t].mirror_offset = off;
+            off += P.jobs[t].offdiag;
+        }
+    }
+    pthread_barrier_wait(&P.barrier);
+
+    /* Pass 3: mirror the off-diagonal entries. */
+    GrB_Index m = job->mirror_offset;
+    for (GrB_Index s = job->offset; s < k; ++s) {
+        if (P.I[s] == P.J[s]) continue;
+        P.I[m] = P.J[s];
+        P.J[m] = P.I[s];
+        P.val[m] = (P.skew? -P.val[s] : P.val[s]);
+        ++m;
+    }
+    return NULL;
+}
+
 int main(int argc, char *argv[])
 {
     int ret_code;
     MM_typecode matcode;
     FILE *f;
-    int M, N, nz;   
-    GrB_Index i, *I, *J;
-    double *val;
+    int M, N, nz;
+    int nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    int lower_only = 0;
+    const char *outname = "out.bin";
+
+    int c;
+    while ((c = getopt(argc, argv, "t:l")) != -1) {
+        switch (c) {
+        case 't': nthreads = atoi(optarg); break;
+        case 'l': lower_only = 1; break;
+        default:
+            fprintf(stderr, "Usage: %s [-t nthreads] [-l] [martix-market-filename] [out.bin]\n", argv[0]);
+            exit(1);
+        }
+    }
+    if (nthreads < 1) nthreads = 1;
 
-    if (argc < 2)
+    if (optind >= argc)
 	{
-		fprintf(stderr, "Usage: %s [martix-market-filename]\n", argv[0]);
+		fprintf(stderr, "Usage: %s [-t nthreads] [-l] [martix-market-filename] [out.bin]\n", argv[0]);
 		exit(1);
 	}
-    else    
-    { 
-        if ((f = fopen(argv[1], "r")) == NULL) 
+    else
+    {
+        if ((f = fopen(argv[optind], "r")) == NULL)
             exit(1);
     }
+    if (optind + 1 < argc) outname = argv[optind + 1];
 
     if (mm_read_banner(f, &matcode) != 0)
     {
@@ -59,7 +266,8 @@ int main(int argc, char *argv[])
     /*  This is how one can screen matrix types if their application */
     /*  only supports a subset of the Matrix Market data types.      */
 
-    if (!mm_is_matrix(matcode) || !mm_is_sparse(matcode) )
+    if (!mm_is_matrix(matcode) || !mm_is_sparse(matcode)
+        || mm_is_complex(matcode) || mm_is_hermitian(matcode))
     {
         printf("Sorry, this application does not support ");
         printf("Market Market type: [%s]\n", mm_typecode_to_str(matcode));
@@ -71,50 +279,106 @@ int main(int argc, char *argv[])
     if ((ret_code = mm_read_mtx_crd_size(f, &M, &N, &nz)) !=0)
         exit(1);
 
-    uint64_t sizes[3] = {M, N, nz};
+    long data_off = ftell(f);
+    fclose(f);
 
-    I = malloc(nz * sizeof(*I));
-    J = malloc(nz * sizeof(*J));
-    val = malloc(nz * sizeof(*val));
+    int fd = open(argv[optind], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) { perror(argv[optind]); exit(1); }
+    const char *map = NULL;
+    if (st.st_size > data_off) {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) { perror(argv[optind]); exit(1); }
+        madvise((void *)map, st.st_size, MADV_SEQUENTIAL);
+    }
+    close(fd);
 
-    /* NOTE: when reading in doubles, ANSI C requires the use of the "l"  */
-    /*   specifier as in "%lg", "%lf", "%le", otherwise errors will occur */
-    /*  (ANSI C X3.159-1989, Sec. 4.9.6.2, p. 136 lines 13-15)            */
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
 
-    fprintf(stderr, "NZ %ld  %ld %ld\n", (long)nz, (long)M, (long)N);
-    for (i=0; i<nz; i++)
-    {
-        long edge[2];
-        int tmp = fscanf(f, "%ld %ld %lg\n", &edge[0], &edge[1], &val[i]);
-        //assert(tmp == 3);
-        if (tmp < 3) break;
-        I[i] = edge[0];
-        J[i] = edge[1];
-        if (i < 20) fprintf(stderr, "%ld %ld %g\n", (long)I[i], (long)J[i], val[i]);
-        if (I[i] <= 0) fprintf(stderr, "I[%ld] %ld 0\n", (long)i, (long)I[i]);
-        if (J[i] <= 0) fprintf(stderr, "J[%ld] %ld 0\n", (long)i, (long)J[i]);
-        assert(I[i] > 0);
-        assert(J[i] > 0);
-        I[i]--;  /* adjust from 1-based to 0-based */
-        J[i]--;
-        if (I[i] >= M) fprintf(stderr, "I[%ld] %ld %ld\n", (long)i, (long)I[i], (long)M);
-        if (J[i] >= N) fprintf(stderr, "J[%ld] %ld %ld\n", (long)i, (long)J[i], (long)N);
-        assert(I[i] < M);
-        assert(J[i] < N);
-    }
-    sizes[2] = i;
-
-    FILE *out = fopen("out.bin", "wb");
+    P.nthreads = nthreads;
+    P.pattern = mm_is_pattern(matcode);
+    P.skew = mm_is_skew(matcode);
+    P.expand = !lower_only && (mm_is_symmetric(matcode) || P.skew);
+    P.M = M; P.N = N; P.nz = nz;
+
+    GrB_Index cap = (P.expand? 2 * (GrB_Index)nz : (GrB_Index)nz);
+    P.I = malloc((cap? cap : 1) * sizeof(*P.I));
+    P.J = malloc((cap? cap : 1) * sizeof(*P.J));
+    P.val = malloc((cap? cap : 1) * sizeof(*P.val));
+    P.jobs = calloc(nthreads, sizeof(*P.jobs));
+    if (!P.I || !P.J || !P.val || !P.jobs) { perror("malloc"); exit(1); }
+
+    /* Split the entries at line boundaries. */
+    const char *data = (map? map + data_off : NULL);
+    size_t len = (map? st.st_size - data_off : 0);
+    const char *prev = data;
+    for (int t = 0; t < nthreads; ++t) {
+        const char *cut = data + len * (t + 1) / nthreads;
+        if (t < nthreads - 1 && cut > prev) {
+            const char *nl = memchr(cut - 1, '\n', data + len - (cut - 1));
+            cut = (nl? nl + 1 : data + len);
+        }
+        if (cut < prev) cut = prev;
+        if (t == nthreads - 1) cut = data + len;
+        P.jobs[t].id = t;
+        P.jobs[t].begin = prev;
+        P.jobs[t].end = cut;
+        prev = cut;
+    }
+
+    pthread_barrier_init(&P.barrier, NULL, nthreads);
+    pthread_t *tid = malloc(nthreads * sizeof(*tid));
+    for (int t = 1; t < nthreads; ++t)
+        pthread_create(&tid[t], NULL, parse_chunk, &P.jobs[t]);
+    parse_chunk(&P.jobs[0]);
+    for (int t = 1; t < nthreads; ++t)
+        pthread_join(tid[t], NULL);
+    pthread_barrier_destroy(&P.barrier);
+    free(tid);
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    GrB_Index found = 0, mirrored = 0;
+    for (int t = 0; t < nthreads; ++t) {
+        if (P.jobs[t].bad_line) {
+            GrB_Index line = P.jobs[t].bad_line;
+            for (const char *p = data; p < P.jobs[t].begin; ++p) line += (*p == '\n');
+            fprintf(stderr, "%s: bad entry on data line %ld\n",
+                    argv[optind], (long)line);
+            exit(1);
+        }
+        found += P.jobs[t].count;
+        mirrored += P.jobs[t].offdiag;
+    }
+    if (found != (GrB_Index)nz) {
+        fprintf(stderr, "%s: found %ld entries, header declares %ld\n",
+                argv[optind], (long)found, (long)nz);
+        if (found < (GrB_Index)nz) exit(1);
+    }
+    GrB_Index nout = nz + (P.expand? mirrored : 0);
+
+    double secs = (t1.tv_sec - t0.tv_sec) + 1.0e-9 * (t1.tv_nsec - t0.tv_nsec);
+    fprintf(stderr, "NZ %ld  %ld %ld (%ld written), %d threads, %.3f s, %.1f MB/s\n",
+            (long)nz, (long)M, (long)N, (long)nout, nthreads, secs,
+            (secs > 0? len * 1.0e-6 / secs : 0.0));
+
+    if (map) munmap((void *)map, st.st_size);
+
+    uint64_t sizes[3] = {M, N, nout};
+
+    FILE *out = fopen(outname, "wb");
+    if (!out) { perror(outname); exit(1); }
 
     fwrite(sizes, sizeof(uint64_t), 3, out);
 
-    fwrite(I, sizeof(*I), nz, out);
-    fwrite(J, sizeof(*J), nz, out);
-    fwrite(val, sizeof(*val), nz, out);
+    fwrite(P.I, sizeof(*P.I), nout, out);
+    fwrite(P.J, sizeof(*P.J), nout, out);
+    fwrite(P.val, sizeof(*P.val), nout, out);
 
-    fclose(out);
+    if (fclose(out) != 0) { perror(outname); exit(1); }
 
-    if (f !=stdin) fclose(f);
+    free(P.jobs);
+    free(P.val); free(P.J); free(P.I);
 	return 0;
 }
-
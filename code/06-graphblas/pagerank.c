@@ -1,54 +1,71 @@
+#include <stdio.h>
+#include <time.h>
 #include <GraphBLAS.h>
 
-extern void degree_pseudoinv(GrB_Vector* v, GrB_Matrix A);
+#include "graph.h"
+#include "pr_delta.h"
+
 extern void scale_vector(GrB_Vector v, double scl);
+extern size_t gb_bytes_allocated(size_t *ncalls);
+
+// When set, print each iteration's time, change and GraphBLAS
+// allocation volume to stderr.
+int pagerank_trace = 0;
 
+// Norm of the change between iterates compared against ctol.
+enum pr_norm pagerank_norm = PR_NORM_LINF;
+
+// The loop works in a fixed set of buffers: x holds the current
+// iterate and accum receives the next one, then the handles swap.
 int pagerank(GrB_Vector *pr,
-             GrB_Matrix A, GrB_Vector v,
+             struct graph *G, GrB_Vector v,
              const double alpha, const double ctol, const int itmax)
 {
-  GrB_Vector v_scaled, x, xprev, accum, D_pseudoinv;
+  GrB_Matrix A = G->A;
+  GrB_Vector v_scaled, x, accum, tmp;
   int k = -1;
 
-  GrB_Index N;
-  GrB_Matrix_nrows(&N, A);
+  GrB_Index N = graph_nrows(G);
   if (N == 0) return 0;
 
   {
-    GrB_Index NE;
-    GrB_Matrix_nvals(&NE, A);
+    GrB_Index NE = graph_nvals(G);
     if (NE == 0) return 0;
     GrB_Vector_nvals(&NE, v);
     if (NE == 0) return 0;
   }
 
-  GrB_Vector_new(&v_scaled, GrB_FP64, N);
   GrB_Vector_new(&x, GrB_FP64, N);
-  GrB_Vector_new(&xprev, GrB_FP64, N);
   GrB_Vector_new(&accum, GrB_FP64, N);
-  GrB_Vector_new(&D_pseudoinv, GrB_FP64, N);
 
-  degree_pseudoinv(&D_pseudoinv, A);
+  GrB_Vector D_pseudoinv = graph_degree_pseudoinv(G);
   GrB_Vector_dup(&v_scaled, v);
   scale_vector(v_scaled, 1.0 - alpha);
 
   for (k = 0; k < itmax; ++k) {
-    GrB_assign(xprev, GrB_NULL, GrB_NULL, x, GrB_ALL, N, GrB_DESC_R);
+    struct timespec t0, t1;
+    size_t bytes0 = 0, calls0 = 0;
+    if (pagerank_trace) {
+      bytes0 = gb_bytes_allocated(&calls0);
+      clock_gettime(CLOCK_MONOTONIC, &t0);
+    }
 
     GrB_vxm(accum, GrB_NULL, GrB_NULL, GrB_PLUS_TIMES_SEMIRING_FP64, x, A, GrB_DESC_R);
-    GrB_eWiseAdd(accum, GrB_NULL, GrB_NULL, GrB_TIMES_FP64, D_pseudoinv, accum, GrB_DESC_R);
+    GrB_eWiseAdd(accum, GrB_NULL, GrB_NULL, GrB_TIMES_FP64, D_pseudoinv, accum, GrB_NULL);
     scale_vector(accum, alpha);
+    GrB_eWiseAdd(accum, GrB_NULL, GrB_NULL, GrB_PLUS_FP64, v_scaled, accum, GrB_NULL);
 
-    GrB_eWiseAdd(accum, GrB_NULL, GrB_NULL, GrB_PLUS_FP64, v_scaled, accum, GrB_DESC_R);
-
-    GrB_assign(x, GrB_NULL, GrB_NULL, accum, GrB_ALL, N, GrB_DESC_R);
+    double diff = pr_delta(NULL, accum, x, pagerank_norm);
+    tmp = x; x = accum; accum = tmp;
 
-    // Re-use xprev for "convergence" check
-    GrB_eWiseAdd(xprev, GrB_NULL, GrB_NULL, GrB_MINUS_FP64, accum, xprev, GrB_DESC_R);
-    GrB_apply(xprev, GrB_NULL, GrB_NULL, GrB_ABS_FP64, xprev, GrB_DESC_R);
-    double diff = 0.0;
-    GrB_reduce(&diff, GrB_NULL, GrB_MAX_MONOID_FP64, xprev, GrB_NULL);
-    //fprintf(stderr, "norm1 diff %lg\n", diff);
+    if (pagerank_trace) {
+      size_t calls1, bytes1 = gb_bytes_allocated(&calls1);
+      clock_gettime(CLOCK_MONOTONIC, &t1);
+      fprintf(stderr, "pagerank it %d diff %lg time %.3f ms alloc %zu B in %zu calls\n",
+              k, diff,
+              1.0e3 * (t1.tv_sec - t0.tv_sec) + 1.0e-6 * (t1.tv_nsec - t0.tv_nsec),
+              bytes1 - bytes0, calls1 - calls0);
+    }
     if (diff <= ctol) break;
   }
 
@@ -57,12 +74,10 @@ int pagerank(GrB_Vector *pr,
   if (sum != 0)
     scale_vector(x, 1.0/sum);
 
-  GrB_Vector_dup(pr, x);
+  // Hand the iterate over rather than duplicating it.
+  *pr = x;
 
-  GrB_free(&D_pseudoinv);
   GrB_free(&accum);
-  GrB_free(&xprev);
-  GrB_free(&x);
   GrB_free(&v_scaled);
 
   return k;
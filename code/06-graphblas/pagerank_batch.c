@@ -0,0 +1,162 @@
+#include <stdlib.h>
+#include <math.h>
+#include <GraphBLAS.h>
+
+#include "graph.h"
+
+static void
+absdiff(void *z, const void *x, const void *y)
+{
+  *(double *)z = fabs(*(const double *)x - *(const double *)y);
+}
+
+// C = nrows copies of d as rows.
+static void
+broadcast_rows(GrB_Matrix *C, GrB_Vector d, GrB_Index nrows)
+{
+  GrB_Index N;
+  GrB_Vector_size(&N, d);
+
+  GrB_Matrix ones, drow;
+  GrB_Matrix_new(&ones, GrB_FP64, nrows, 1);
+  GrB_assign(ones, GrB_NULL, GrB_NULL, 1.0, GrB_ALL, nrows, GrB_ALL, 1, GrB_NULL);
+  GrB_Matrix_new(&drow, GrB_FP64, 1, N);
+  GrB_Row_assign(drow, GrB_NULL, GrB_NULL, d, 0, GrB_ALL, N, GrB_NULL);
+
+  GrB_Matrix_new(C, GrB_FP64, nrows, N);
+  GrB_kronecker(*C, GrB_NULL, GrB_NULL, GrB_TIMES_FP64, ones, drow, GrB_NULL);
+
+  GrB_free(&drow);
+  GrB_free(&ones);
+}
+
+// C = the rows of A listed in rows, renumbered 0..n-1.
+static void
+take_rows(GrB_Matrix *C, GrB_Matrix A, const GrB_Index *rows, GrB_Index n)
+{
+  GrB_Index N;
+  GrB_Matrix_ncols(&N, A);
+  GrB_Matrix_new(C, GrB_FP64, n, N);
+  GrB_extract(*C, GrB_NULL, GrB_NULL, A, rows, n, GrB_ALL, N, GrB_NULL);
+}
+
+// Batched personalized PageRank.  Row s of the k-by-N matrix V is the
+// teleport vector of query s, and row s of *pr receives its scores.
+// All active queries advance together with one GrB_mxm per iteration,
+// so A is read once for the whole batch.  Each query follows
+// pagerank()'s update and stopping rule on its own row.  A query that
+// converges is written out and dropped from the active set.  If iters
+// is not NULL, iters[s] receives query s's iteration count.  Returns
+// the largest count.
+int pagerank_batch(GrB_Matrix *pr, int *iters,
+                   struct graph *G, GrB_Matrix V,
+                   const double alpha, const double ctol, const int itmax)
+{
+  GrB_Matrix A = G->A;
+  GrB_Matrix X, accum, tmp, Vs, Dk;
+  GrB_Vector rowdiff;
+  GrB_BinaryOp absdiff_op;
+  int k, kmax = 0;
+
+  GrB_Index N = graph_nrows(G), nq;
+  GrB_Matrix_nrows(&nq, V);
+  if (N == 0 || nq == 0) return 0;
+
+  GrB_Matrix_new(pr, GrB_FP64, nq, N);
+
+  // active[a] is the query held in row a of the working matrices.
+  GrB_Index na = nq;
+  GrB_Index *active = malloc(nq * sizeof(*active));
+  GrB_Index *keep = malloc(nq * sizeof(*keep));
+  GrB_Index *done = malloc(nq * sizeof(*done));
+  GrB_Index *rowid = malloc(nq * sizeof(*rowid));
+  double *rowval = malloc(nq * sizeof(*rowval));
+  for (GrB_Index s = 0; s < nq; ++s) active[s] = s;
+
+  GrB_BinaryOp_new(&absdiff_op, absdiff, GrB_FP64, GrB_FP64, GrB_FP64);
+  GrB_Vector D_pseudoinv = graph_degree_pseudoinv(G);
+  broadcast_rows(&Dk, D_pseudoinv, na);
+
+  GrB_Matrix_dup(&Vs, V);
+  GrB_apply(Vs, GrB_NULL, GrB_NULL, GrB_TIMES_FP64, Vs, 1.0 - alpha, GrB_NULL);
+
+  GrB_Matrix_new(&X, GrB_FP64, na, N);
+  GrB_Matrix_new(&accum, GrB_FP64, na, N);
+  GrB_Vector_new(&rowdiff, GrB_FP64, na);
+
+  for (k = 0; k < itmax && na > 0; ++k) {
+    GrB_mxm(accum, GrB_NULL, GrB_NULL, GrB_PLUS_TIMES_SEMIRING_FP64, X, A, GrB_DESC_R);
+    GrB_eWiseAdd(accum, GrB_NULL, GrB_NULL, GrB_TIMES_FP64, Dk, accum, GrB_NULL);
+    GrB_apply(accum, GrB_NULL, GrB_NULL, GrB_TIMES_FP64, accum, alpha, GrB_NULL);
+    GrB_eWiseAdd(accum, GrB_NULL, GrB_NULL, GrB_PLUS_FP64, Vs, accum, GrB_NULL);
+
+    GrB_eWiseAdd(X, GrB_NULL, GrB_NULL, absdiff_op, accum, X, GrB_NULL);
+    tmp = X; X = accum; accum = tmp;
+
+    // Per-query max change; rows with no entries have none to make.
+    GrB_Vector_clear(rowdiff);
+    GrB_reduce(rowdiff, GrB_NULL, GrB_NULL, GrB_MAX_MONOID_FP64, accum, GrB_NULL);
+    GrB_Index nd = na;
+    GrB_Vector_extractTuples(rowid, rowval, &nd, rowdiff);
+
+    GrB_Index nkeep = 0, ndone = 0;
+    for (GrB_Index a = 0, t = 0; a < na; ++a) {
+      double diff = 0.0;
+      if (t < nd && rowid[t] == a) diff = rowval[t++];
+      if (diff <= ctol || k == itmax - 1) {
+        // Count like pagerank(): itmax if it never converged.
+        int it = (diff <= ctol? k : itmax);
+        if (iters) iters[active[a]] = it;
+        if (it > kmax) kmax = it;
+        done[ndone++] = a;
+      }
+      else keep[nkeep++] = a;
+    }
+    if (ndone == 0) continue;
+
+    // Write out the finished queries, then compact the rest.
+    take_rows(&tmp, X, done, ndone);
+    for (GrB_Index d = 0; d < ndone; ++d) rowid[d] = active[done[d]];
+    GrB_assign(*pr, GrB_NULL, GrB_NULL, tmp, rowid, ndone, GrB_ALL, N, GrB_NULL);
+    GrB_free(&tmp);
+
+    if (nkeep == 0) { na = 0; break; }
+
+    take_rows(&tmp, X, keep, nkeep);
+    GrB_free(&X); X = tmp;
+    take_rows(&tmp, Vs, keep, nkeep);
+    GrB_free(&Vs); Vs = tmp;
+    for (GrB_Index a = 0; a < nkeep; ++a) active[a] = active[keep[a]];
+    na = nkeep;
+
+    GrB_free(&Dk);
+    broadcast_rows(&Dk, D_pseudoinv, na);
+    GrB_Matrix_resize(accum, na, N);
+    GrB_Vector_resize(rowdiff, na);
+  }
+
+  // Normalize each query's scores to sum to one, as pagerank() does.
+  GrB_Vector sums, zero;
+  GrB_Vector_new(&sums, GrB_FP64, nq);
+  GrB_Vector_new(&zero, GrB_FP64, nq);
+  GrB_reduce(sums, GrB_NULL, GrB_NULL, GrB_PLUS_MONOID_FP64, *pr, GrB_NULL);
+  GrB_select(zero, GrB_NULL, GrB_NULL, GrB_VALUEEQ_FP64, sums, 0.0, GrB_NULL);
+  GrB_assign(sums, zero, GrB_NULL, 1.0, GrB_ALL, nq, GrB_DESC_S);
+  GrB_apply(sums, GrB_NULL, GrB_NULL, GrB_MINV_FP64, sums, GrB_NULL);
+  GrB_Matrix S;
+  GrB_Matrix_diag(&S, sums, 0);
+  GrB_mxm(*pr, GrB_NULL, GrB_NULL, GrB_PLUS_TIMES_SEMIRING_FP64, S, *pr, GrB_NULL);
+
+  GrB_free(&S);
+  GrB_free(&zero);
+  GrB_free(&sums);
+  GrB_free(&rowdiff);
+  GrB_free(&accum);
+  GrB_free(&X);
+  GrB_free(&Vs);
+  GrB_free(&Dk);
+  GrB_free(&absdiff_op);
+  free(rowval); free(rowid); free(done); free(keep); free(active);
+
+  return kmax;
+}
@@ -0,0 +1,80 @@
+#include <GraphBLAS.h>
+
+#include "graph.h"
+
+extern void scale_vector(GrB_Vector v, double scl);
+
+// Personalized PageRank by residual push (Andersen, Chung & Lang,
+// FOCS'06).  The residual r starts at the teleport vector v.  Every
+// vertex u with r(u) > ctol * deg(u) moves (1-alpha) r(u) into the
+// estimate p and spreads alpha r(u) over its out-edges.  The pushes of
+// one round run together as a vxm from the sparse set of pushing
+// vertices, so each round only reads the rows of vertices holding
+// residual.  Out-degrees come from the graph's cached row sums.  Mass
+// reaching a vertex with no out-edges is settled there and not passed
+// on.  itmax bounds the number of rounds.  The result is normalized to
+// sum to one, like pagerank().
+int pagerank_push(GrB_Vector *pr,
+                  struct graph *G, GrB_Vector v,
+                  const double alpha, const double ctol, const int itmax)
+{
+  GrB_Matrix A = G->A;
+  GrB_Vector p, r, deg, s, F;
+  int k = -1;
+
+  GrB_Index N = graph_nrows(G);
+  if (N == 0) return 0;
+
+  {
+    GrB_Index NE = graph_nvals(G);
+    if (NE == 0) return 0;
+    GrB_Vector_nvals(&NE, v);
+    if (NE == 0) return 0;
+  }
+
+  GrB_Vector_new(&p, GrB_FP64, N);
+  GrB_Vector_new(&deg, GrB_FP64, N);
+  GrB_Vector_new(&s, GrB_FP64, N);
+  GrB_Vector_new(&F, GrB_FP64, N);
+  GrB_Vector_dup(&r, v);
+
+  GrB_Vector rowsum = graph_rowsum(G);
+
+  for (k = 0; k < itmax; ++k) {
+    // Weighted out-degrees of the vertices holding residual.
+    GrB_apply(deg, r, GrB_NULL, GrB_IDENTITY_FP64, rowsum, GrB_DESC_RS);
+
+    // F = r where r - ctol * deg > 0.
+    GrB_apply(s, GrB_NULL, GrB_NULL, GrB_TIMES_FP64, deg, ctol, GrB_DESC_R);
+    GrB_eWiseAdd(s, GrB_NULL, GrB_NULL, GrB_MINUS_FP64, r, s, GrB_NULL);
+    GrB_select(s, GrB_NULL, GrB_NULL, GrB_VALUEGT_FP64, s, 0.0, GrB_NULL);
+    GrB_apply(F, s, GrB_NULL, GrB_IDENTITY_FP64, r, GrB_DESC_RS);
+
+    GrB_Index nF;
+    GrB_Vector_nvals(&nF, F);
+    if (nF == 0) break;
+
+    // Settle, then clear the pushed residual.
+    GrB_apply(p, GrB_NULL, GrB_PLUS_FP64, GrB_TIMES_FP64, F, 1.0 - alpha, GrB_NULL);
+    GrB_apply(r, s, GrB_NULL, GrB_IDENTITY_FP64, r, GrB_DESC_RSC);
+
+    // r += alpha * (F ./ deg) * A
+    GrB_eWiseMult(s, GrB_NULL, GrB_NULL, GrB_DIV_FP64, F, deg, GrB_DESC_R);
+    scale_vector(s, alpha);
+    GrB_vxm(r, GrB_NULL, GrB_PLUS_FP64, GrB_PLUS_TIMES_SEMIRING_FP64, s, A, GrB_NULL);
+  }
+
+  double sum;
+  GrB_reduce(&sum, GrB_NULL, GrB_PLUS_MONOID_FP64, p, GrB_NULL);
+  if (sum != 0)
+    scale_vector(p, 1.0/sum);
+
+  *pr = p;
+
+  GrB_free(&F);
+  GrB_free(&s);
+  GrB_free(&deg);
+  GrB_free(&r);
+
+  return k;
+}
@@ -0,0 +1,17 @@
+#if !defined(PR_DELTA_H)
+#define PR_DELTA_H
+
+#include <GraphBLAS.h>
+
+enum pr_norm { PR_NORM_LINF = 0, PR_NORM_L1, PR_NORM_L2 };
+
+struct pr_delta {
+  double l1, l2, linf;
+};
+
+// Norms of xnew - xold with absent entries read as zero, computed in
+// one pass over both vectors.  Returns the one selected by norm.
+extern double pr_delta(struct pr_delta *d, GrB_Vector xnew, GrB_Vector xold,
+                       enum pr_norm norm);
+
+#endif
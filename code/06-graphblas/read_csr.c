@@ -0,0 +1,77 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <GraphBLAS.h>
+
+#include <assert.h>
+
+#include "graph_csr.h"
+
+static void
+read_or_die(void *buf, size_t len, FILE *f, const char *fname, uint32_t *crc)
+{
+  if (fread(buf, 1, len, f) != len) {
+    fprintf(stderr, "%s: truncated CSR payload\n", fname); abort();
+  }
+  *crc = csr_crc32(*crc, buf, len);
+}
+
+// Load a graph_csr.h file.  The arrays are read straight into buffers
+// that GraphBLAS adopts with GxB_Matrix_import_CSR, so there is no
+// sort, no dedup and no second copy.  Returns the bytes read.
+size_t
+read_csr(GrB_Matrix *A, const char *fname)
+{
+  GrB_Info info;
+  FILE *f = fopen(fname, "rb");
+  if (!f) { perror("File opening error"); abort(); }
+
+  struct csr_header h;
+  if (fread(&h, sizeof(h), 1, f) != 1 || h.magic != CSR_MAGIC) {
+    fprintf(stderr, "%s: not a CSR graph file\n", fname); abort();
+  }
+  if (h.version != CSR_VERSION) {
+    fprintf(stderr, "%s: CSR version %u, expected %u\n", fname,
+            (unsigned)h.version, (unsigned)CSR_VERSION);
+    abort();
+  }
+
+  assert(h.nrows == h.ncols);
+
+  uint32_t crc_want = h.crc;
+  h.crc = 0;
+  uint32_t crc = csr_crc32(0, &h, sizeof(h));
+
+  const int weighted = (h.flags & CSR_WEIGHTED) != 0;
+  GrB_Index Ap_size = (h.nrows + 1) * sizeof(GrB_Index);
+  GrB_Index Aj_size = (h.nvals? h.nvals : 1) * sizeof(GrB_Index);
+  GrB_Index Ax_size = (weighted && h.nvals? h.nvals : 1) * sizeof(double);
+
+  GrB_Index *Ap = malloc(Ap_size);
+  GrB_Index *Aj = malloc(Aj_size);
+  double *Ax = malloc(Ax_size);
+  assert(Ap && Aj && Ax);
+
+  read_or_die(Ap, (h.nrows + 1) * sizeof(*Ap), f, fname, &crc);
+  read_or_die(Aj, h.nvals * sizeof(*Aj), f, fname, &crc);
+  if (weighted) read_or_die(Ax, h.nvals * sizeof(*Ax), f, fname, &crc);
+  else Ax[0] = 1.0;
+  fclose(f);
+
+  if (crc != crc_want) {
+    fprintf(stderr, "%s: CRC mismatch (%08x, header says %08x)\n",
+            fname, (unsigned)crc, (unsigned)crc_want);
+    abort();
+  }
+  if (Ap[0] != 0 || Ap[h.nrows] != h.nvals) {
+    fprintf(stderr, "%s: malformed row pointers\n", fname); abort();
+  }
+
+  info = GxB_Matrix_import_CSR(A, GrB_FP64, h.nrows, h.ncols,
+                               &Ap, &Aj, (void **)&Ax,
+                               Ap_size, Aj_size, Ax_size,
+                               !weighted, !(h.flags & CSR_SORTED), GrB_NULL);
+  assert(info == GrB_SUCCESS);
+
+  return sizeof(h) + csr_payload_bytes(&h);
+}
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "region.h"
+
+extern size_t gb_bytes_allocated(size_t *ncalls);
+
+#define REGION_MAX_DEPTH 16
+
+struct region {
+  const char *name;
+  double wall, cpu;
+  size_t bytes, calls;
+};
+
+static struct region stack[REGION_MAX_DEPTH];
+static int depth = 0;
+static int run = -1;
+static FILE *out = NULL;
+
+static double
+clock_sec(clockid_t id)
+{
+  struct timespec t;
+  clock_gettime(id, &t);
+  return t.tv_sec + 1.0e-9 * t.tv_nsec;
+}
+
+void
+region_output(FILE *f)
+{
+  out = f;
+}
+
+void
+region_set_run(int r)
+{
+  run = r;
+}
+
+void
+region_begin(const char *name)
+{
+  if (depth == REGION_MAX_DEPTH) {
+    fprintf(stderr, "Regions nested deeper than %d at %s\n", REGION_MAX_DEPTH, name);
+    abort();
+  }
+  struct region *r = &stack[depth++];
+  r->name = name;
+  r->bytes = gb_bytes_allocated(&r->calls);
+  r->cpu = clock_sec(CLOCK_PROCESS_CPUTIME_ID);
+  r->wall = clock_sec(CLOCK_MONOTONIC);
+}
+
+double
+region_end(int64_t nnz)
+{
+  const double wall = clock_sec(CLOCK_MONOTONIC);
+  const double cpu = clock_sec(CLOCK_PROCESS_CPUTIME_ID);
+
+  if (depth == 0) {
+    fprintf(stderr, "region_end without region_begin\n");
+    abort();
+  }
+  struct region *r = &stack[--depth];
+  const double wall_ms = 1.0e3 * (wall - r->wall);
+
+  if (out) {
+    size_t calls;
+    size_t bytes = gb_bytes_allocated(&calls);
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+
+    fprintf(out, "{\"region\":\"%s\",\"depth\":%d", r->name, depth);
+    if (run >= 0) fprintf(out, ",\"run\":%d", run);
+    fprintf(out, ",\"wall_ms\":%.6f,\"cpu_ms\":%.6f,\"maxrss_kb\":%ld"
+            ",\"gb_bytes\":%zu,\"gb_allocs\":%zu",
+            wall_ms, 1.0e3 * (cpu - r->cpu), (long)ru.ru_maxrss,
+            bytes - r->bytes, calls - r->calls);
+    if (nnz >= 0) fprintf(out, ",\"nnz\":%ld", (long)nnz);
+    fprintf(out, "}\n");
+    fflush(out);
+  }
+
+  return wall_ms;
+}
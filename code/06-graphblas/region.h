@@ -0,0 +1,17 @@
+#if !defined(REGION_H)
+#define REGION_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Phase instrumentation in the spirit of hooks_region_begin/end.
+// Regions nest.  region_end() returns the wall time in ms and, once
+// region_output() has been given a stream, writes one JSON object per
+// region with wall and CPU time, peak RSS, the GraphBLAS allocation
+// volume inside the region and the nnz the caller reports (-1 if none).
+extern void region_output(FILE *out);
+extern void region_set_run(int run);
+extern void region_begin(const char *name);
+extern double region_end(int64_t nnz);
+
+#endif
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reorder.h"
+
+// Out-neighbors with more entries than this are not expanded for
+// Gorder's sibling scores; hubs would make every placement quadratic.
+#define GORDER_HUB_CAP 256
+
+static const char *names[] = { "none", "degree", "rcm", "gorder" };
+
+int
+reorder_parse(enum reorder_method *m, const char *name)
+{
+  for (int k = 0; k < (int)(sizeof(names) / sizeof(names[0])); ++k)
+    if (!strcmp(name, names[k])) { *m = k; return 0; }
+  return -1;
+}
+
+const char *
+reorder_name(enum reorder_method m)
+{
+  return names[m];
+}
+
+static uint64_t
+max_degree(const uint64_t *Ap, uint64_t n)
+{
+  uint64_t d = 0;
+  for (uint64_t v = 0; v < n; ++v)
+    if (Ap[v+1] - Ap[v] > d) d = Ap[v+1] - Ap[v];
+  return d;
+}
+
+// Counting sort on degree, stable in vertex id.
+static void
+by_degree(uint64_t *out, const uint64_t *Ap, uint64_t n, int descending)
+{
+  const uint64_t maxd = max_degree(Ap, n);
+  uint64_t *pos = calloc(maxd + 2, sizeof(*pos));
+  for (uint64_t v = 0; v < n; ++v) {
+    uint64_t d = Ap[v+1] - Ap[v];
+    ++pos[(descending? maxd - d : d) + 1];
+  }
+  for (uint64_t d = 0; d <= maxd; ++d) pos[d+1] += pos[d];
+  for (uint64_t v = 0; v < n; ++v) {
+    uint64_t d = Ap[v+1] - Ap[v];
+    out[pos[descending? maxd - d : d]++] = v;
+  }
+  free(pos);
+}
+
+struct deg_vtx { uint64_t deg, v; };
+
+static int
+deg_vtx_cmp(const void *a_, const void *b_)
+{
+  const struct deg_vtx *a = a_, *b = b_;
+  if (a->deg != b->deg) return (a->deg < b->deg? -1 : 1);
+  return (a->v < b->v? -1 : a->v > b->v);
+}
+
+// Cuthill-McKee from the lowest-degree vertex of each component,
+// neighbors visited in increasing degree, then reversed.
+static void
+rcm(uint64_t *perm, const uint64_t *Ap, const uint64_t *Aj, uint64_t n)
+{
+  uint64_t *starts = malloc(n * sizeof(*starts));
+  char *seen = calloc(n, 1);
+  struct deg_vtx *nbr = malloc((max_degree(Ap, n) + 1) * sizeof(*nbr));
+  by_degree(starts, Ap, n, 0);
+
+  uint64_t head = 0, tail = 0;
+  for (uint64_t s = 0; s < n; ++s) {
+    uint64_t root = starts[s];
+    if (seen[root]) continue;
+    seen[root] = 1;
+    perm[tail++] = root;
+    while (head < tail) {
+      uint64_t v = perm[head++], nn = 0;
+      for (uint64_t k = Ap[v]; k < Ap[v+1]; ++k) {
+        uint64_t u = Aj[k];
+        if (seen[u]) continue;
+        seen[u] = 1;
+        nbr[nn].deg = Ap[u+1] - Ap[u];
+        nbr[nn++].v = u;
+      }
+      qsort(nbr, nn, sizeof(*nbr), deg_vtx_cmp);
+      for (uint64_t k = 0; k < nn; ++k) perm[tail++] = nbr[k].v;
+    }
+  }
+
+  for (uint64_t k = 0; k < n / 2; ++k) {
+    uint64_t tmp = perm[k];
+    perm[k] = perm[n-1-k];
+    perm[n-1-k] = tmp;
+  }
+
+  free(nbr);
+  free(seen);
+  free(starts);
+}
+
+// Unplaced vertices live in doubly linked lists bucketed by score.
+// Scores move by one at a time, so the highest non-empty bucket is
+// found by walking top down from wherever the last increment left it.
+struct buckets {
+  int64_t *score, *next, *prev, *head;
+  int64_t nhead, top;
+  char *placed;
+};
+
+static void
+bucket_unlink(struct buckets *B, uint64_t u)
+{
+  int64_t p = B->prev[u], q = B->next[u];
+  if (p >= 0) B->next[p] = q; else B->head[B->score[u]] = q;
+  if (q >= 0) B->prev[q] = p;
+}
+
+static void
+bucket_link(struct buckets *B, uint64_t u)
+{
+  int64_t s = B->score[u];
+  if (s >= B->nhead) {
+    int64_t nh = 2 * B->nhead;
+    while (nh <= s) nh *= 2;
+    B->head = realloc(B->head, nh * sizeof(*B->head));
+    for (int64_t k = B->nhead; k < nh; ++k) B->head[k] = -1;
+    B->nhead = nh;
+  }
+  B->prev[u] = -1;
+  B->next[u] = B->head[s];
+  if (B->head[s] >= 0) B->prev[B->head[s]] = u;
+  B->head[s] = u;
+  if (s > B->top) B->top = s;
+}
+
+static inline void
+bucket_adjust(struct buckets *B, uint64_t u, int delta)
+{
+  if (B->placed[u]) return;
+  bucket_unlink(B, u);
+  B->score[u] += delta;
+  bucket_link(B, u);
+}
+
+static void
+gorder_update(struct buckets *B, const uint64_t *Ap, const uint64_t *Aj,
+              uint64_t v, int delta)
+{
+  for (uint64_t k = Ap[v]; k < Ap[v+1]; ++k) {
+    uint64_t x = Aj[k];
+    bucket_adjust(B, x, delta);
+    if (Ap[x+1] - Ap[x] > GORDER_HUB_CAP) continue;
+    for (uint64_t l = Ap[x]; l < Ap[x+1]; ++l)
+      bucket_adjust(B, Aj[l], delta);
+  }
+}
+
+static void
+gorder(uint64_t *perm, const uint64_t *Ap, const uint64_t *Aj, uint64_t n)
+{
+  struct buckets B;
+  B.score = calloc(n, sizeof(*B.score));
+  B.next = malloc(n * sizeof(*B.next));
+  B.prev = malloc(n * sizeof(*B.prev));
+  B.placed = calloc(n, 1);
+  B.nhead = 64;
+  B.head = malloc(B.nhead * sizeof(*B.head));
+  for (int64_t k = 0; k < B.nhead; ++k) B.head[k] = -1;
+  B.top = 0;
+  for (uint64_t v = n; v-- > 0; ) bucket_link(&B, v);
+
+  // Start from the highest-degree vertex.
+  uint64_t v = 0;
+  for (uint64_t u = 1; u < n; ++u)
+    if (Ap[u+1] - Ap[u] > Ap[v+1] - Ap[v]) v = u;
+
+  for (uint64_t k = 0; k < n; ++k) {
+    if (k > 0) {
+      while (B.top > 0 && B.head[B.top] < 0) --B.top;
+      v = B.head[B.top];
+    }
+    bucket_unlink(&B, v);
+    B.placed[v] = 1;
+    perm[k] = v;
+    gorder_update(&B, Ap, Aj, v, 1);
+    if (k >= REORDER_WINDOW) gorder_update(&B, Ap, Aj, perm[k - REORDER_WINDOW], -1);
+  }
+
+  free(B.head);
+  free(B.placed);
+  free(B.prev);
+  free(B.next);
+  free(B.score);
+}
+
+void
+reorder_perm(uint64_t *perm, const uint64_t *Ap, const uint64_t *Aj,
+             uint64_t n, enum reorder_method m)
+{
+  switch (m) {
+  case REORDER_DEGREE: by_degree(perm, Ap, n, 1); break;
+  case REORDER_RCM: rcm(perm, Ap, Aj, n); break;
+  case REORDER_GORDER: gorder(perm, Ap, Aj, n); break;
+  default:
+    for (uint64_t v = 0; v < n; ++v) perm[v] = v;
+  }
+}
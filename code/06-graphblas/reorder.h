@@ -0,0 +1,22 @@
+#if !defined(REORDER_H)
+#define REORDER_H
+
+#include <stdint.h>
+
+// Vertex orderings for locality.  Each fills perm with new -> old
+// vertex ids from the CSR pattern (Ap, Aj) of an n-vertex graph.
+//   REORDER_DEGREE  out-degree descending, ties by id
+//   REORDER_RCM     reverse Cuthill-McKee over out-edges
+//   REORDER_GORDER  greedy window ordering after Gorder (Wei et al.,
+//                   SIGMOD'16), scoring out-neighbors and two-hop
+//                   siblings of the last REORDER_WINDOW placed vertices
+enum reorder_method { REORDER_NONE = 0, REORDER_DEGREE, REORDER_RCM, REORDER_GORDER };
+
+#define REORDER_WINDOW 5
+
+extern int reorder_parse(enum reorder_method *m, const char *name);
+extern const char *reorder_name(enum reorder_method m);
+extern void reorder_perm(uint64_t *perm, const uint64_t *Ap, const uint64_t *Aj,
+                         uint64_t n, enum reorder_method m);
+
+#endif
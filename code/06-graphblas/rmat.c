@@ -0,0 +1,274 @@
+// Generate an R-MAT (Graph500 Kronecker) graph as a .bin triple dump.
+//
+// Usage: rmat [-s scale] [-e edgefactor] [-a A -b B -c C] [-S] [-d] [-p]
+//             [-w] [-r seed] [-t nthreads] out.bin
+//   -s  2^scale vertices [16]
+//   -e  edgefactor * 2^scale generated edges [16]
+//   -a, -b, -c  quadrant probabilities [0.57 0.19 0.19]
+//   -S  symmetrize by also writing every edge reversed
+//   -d  drop duplicate edges (sorts everything in memory)
+//   -p  randomly permute vertex labels
+//   -w  write uniform [0,1) weights as the val array
+//   -r  random seed [1]
+//   -t  worker threads [online cpus]
+//
+// Edges are generated in fixed chunks, each with its own random stream
+// derived from the seed and chunk number, so the output depends only
+// on the options and not on the thread count.  Without -d each chunk
+// goes straight to its place in the I, J (and val) arrays with
+// pwrite(), so memory use is a chunk per thread plus the permutation.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#define CHUNK ((uint64_t)1 << 20)
+
+struct params {
+  int scale;
+  uint64_t nedges;        // generated, before symmetrizing
+  double a, b, c;
+  int symmetrize, dedup, permute, weighted;
+  uint64_t seed;
+  int nthreads;
+
+  uint64_t *perm;
+  int fd;
+  uint64_t nout;          // entries per output array
+  uint64_t next_chunk;
+  pthread_mutex_t lock;
+
+  // -d collects everything here instead of writing.
+  struct edge *all;
+};
+
+struct edge {
+  uint64_t i, j;
+  double w;
+};
+
+static inline uint64_t
+splitmix64(uint64_t *s)
+{
+  uint64_t z = (*s += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+static inline double
+uniform(uint64_t *s)
+{
+  return (splitmix64(s) >> 11) * 0x1.0p-53;
+}
+
+static void
+pwrite_or_die(int fd, const void *buf, size_t len, off_t off)
+{
+  const char *p = buf;
+  while (len > 0) {
+    ssize_t k = pwrite(fd, p, len, off);
+    if (k <= 0) { perror("Write error"); exit(1); }
+    p += k; len -= k; off += k;
+  }
+}
+
+static void
+gen_chunk(const struct params *P, uint64_t c, uint64_t n,
+          uint64_t *I, uint64_t *J, double *W)
+{
+  uint64_t s = P->seed ^ (c * 0xD1B54A32D192ED03ull);
+  const double ab = P->a + P->b, abc = ab + P->c;
+
+  for (uint64_t k = 0; k < n; ++k) {
+    uint64_t u = 0, v = 0;
+    for (int bit = 0; bit < P->scale; ++bit) {
+      const double r = uniform(&s);
+      u = (u << 1) | (r >= ab);
+      v = (v << 1) | ((r >= P->a && r < ab) || r >= abc);
+    }
+    if (P->perm) { u = P->perm[u]; v = P->perm[v]; }
+    I[k] = u; J[k] = v;
+    if (W) W[k] = uniform(&s);
+  }
+  if (P->symmetrize) {
+    memcpy(I + n, J, n * sizeof(*I));
+    memcpy(J + n, I, n * sizeof(*J));
+    if (W) memcpy(W + n, W, n * sizeof(*W));
+  }
+}
+
+static void *
+worker(void *arg)
+{
+  struct params *P = arg;
+  const int mult = (P->symmetrize? 2 : 1);
+  uint64_t *I = malloc(mult * CHUNK * sizeof(*I));
+  uint64_t *J = malloc(mult * CHUNK * sizeof(*J));
+  double *W = (P->weighted? malloc(mult * CHUNK * sizeof(*W)) : NULL);
+  if (!I || !J || (P->weighted && !W)) { perror("Cannot allocate chunk"); exit(1); }
+
+  for (;;) {
+    pthread_mutex_lock(&P->lock);
+    uint64_t c = P->next_chunk++;
+    pthread_mutex_unlock(&P->lock);
+
+    const uint64_t start = c * CHUNK;
+    if (start >= P->nedges) break;
+    const uint64_t n = (P->nedges - start < CHUNK? P->nedges - start : CHUNK);
+    const uint64_t m = mult * n, pos = mult * start;
+
+    gen_chunk(P, c, n, I, J, W);
+
+    if (P->all) {
+      for (uint64_t k = 0; k < m; ++k) {
+        P->all[pos + k].i = I[k];
+        P->all[pos + k].j = J[k];
+        P->all[pos + k].w = (W? W[k] : 1.0);
+      }
+    } else {
+      const off_t hdr = 3 * sizeof(uint64_t), arr = P->nout * sizeof(uint64_t);
+      pwrite_or_die(P->fd, I, m * sizeof(*I), hdr + pos * sizeof(*I));
+      pwrite_or_die(P->fd, J, m * sizeof(*J), hdr + arr + pos * sizeof(*J));
+      if (W) pwrite_or_die(P->fd, W, m * sizeof(*W), hdr + 2 * arr + pos * sizeof(*W));
+    }
+  }
+
+  free(W); free(J); free(I);
+  return NULL;
+}
+
+static int
+edge_cmp(const void *a_, const void *b_)
+{
+  const struct edge *a = a_, *b = b_;
+  if (a->i != b->i) return (a->i < b->i? -1 : 1);
+  return (a->j < b->j? -1 : a->j > b->j);
+}
+
+static void
+write_dedup(struct params *P, uint64_t nv)
+{
+  qsort(P->all, P->nout, sizeof(*P->all), edge_cmp);
+  uint64_t n = 0;
+  for (uint64_t k = 0; k < P->nout; ++k)
+    if (n == 0 || edge_cmp(&P->all[n-1], &P->all[k]) != 0)
+      P->all[n++] = P->all[k];
+  P->nout = n;
+
+  uint64_t sizes[3] = {nv, nv, n};
+  pwrite_or_die(P->fd, sizes, sizeof(sizes), 0);
+
+  // Reuse the chunk-sized staging so the arrays go out in large writes.
+  uint64_t *buf = malloc(CHUNK * sizeof(*buf));
+  const off_t hdr = sizeof(sizes), arr = n * sizeof(uint64_t);
+  for (int which = 0; which < (P->weighted? 3 : 2); ++which)
+    for (uint64_t s = 0; s < n; s += CHUNK) {
+      uint64_t m = (n - s < CHUNK? n - s : CHUNK);
+      for (uint64_t k = 0; k < m; ++k) {
+        const struct edge *e = &P->all[s + k];
+        if (which == 0) buf[k] = e->i;
+        else if (which == 1) buf[k] = e->j;
+        else memcpy(&buf[k], &e->w, sizeof(double));
+      }
+      pwrite_or_die(P->fd, buf, m * sizeof(*buf), hdr + which * arr + s * sizeof(*buf));
+    }
+  free(buf);
+}
+
+static void
+usage(const char *prog)
+{
+  fprintf(stderr, "Usage: %s [-s scale] [-e edgefactor] [-a A -b B -c C] "
+          "[-S] [-d] [-p] [-w] [-r seed] [-t nthreads] out.bin\n", prog);
+  exit(1);
+}
+
+int
+main(int argc, char **argv)
+{
+  struct params P;
+  memset(&P, 0, sizeof(P));
+  P.scale = 16;
+  long edgefactor = 16;
+  P.a = 0.57; P.b = 0.19; P.c = 0.19;
+  P.seed = 1;
+  P.nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+
+  int opt;
+  while ((opt = getopt(argc, argv, "s:e:a:b:c:Sdpwr:t:")) != -1) {
+    switch (opt) {
+    case 's': P.scale = atoi(optarg); break;
+    case 'e': edgefactor = atol(optarg); break;
+    case 'a': P.a = atof(optarg); break;
+    case 'b': P.b = atof(optarg); break;
+    case 'c': P.c = atof(optarg); break;
+    case 'S': P.symmetrize = 1; break;
+    case 'd': P.dedup = 1; break;
+    case 'p': P.permute = 1; break;
+    case 'w': P.weighted = 1; break;
+    case 'r': P.seed = strtoull(optarg, NULL, 0); break;
+    case 't': P.nthreads = atoi(optarg); break;
+    default: usage(argv[0]);
+    }
+  }
+  if (optind != argc - 1 || P.scale < 1 || P.scale > 40 || edgefactor < 1
+      || P.a + P.b + P.c > 1.0)
+    usage(argv[0]);
+  if (P.nthreads < 1) P.nthreads = 1;
+
+  const uint64_t nv = (uint64_t)1 << P.scale;
+  P.nedges = edgefactor * nv;
+  P.nout = (P.symmetrize? 2 : 1) * P.nedges;
+
+  struct timespec t0, t1;
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+
+  if (P.permute) {
+    P.perm = malloc(nv * sizeof(*P.perm));
+    if (!P.perm) { perror("Cannot allocate permutation"); exit(1); }
+    for (uint64_t k = 0; k < nv; ++k) P.perm[k] = k;
+    uint64_t s = ~P.seed;
+    for (uint64_t k = nv - 1; k > 0; --k) {
+      uint64_t r = splitmix64(&s) % (k + 1), tmp = P.perm[k];
+      P.perm[k] = P.perm[r]; P.perm[r] = tmp;
+    }
+  }
+
+  P.fd = open(argv[optind], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (P.fd < 0) { perror(argv[optind]); exit(1); }
+
+  if (P.dedup) {
+    P.all = malloc(P.nout * sizeof(*P.all));
+    if (!P.all) { perror("Cannot allocate edges for -d"); exit(1); }
+  } else {
+    uint64_t sizes[3] = {nv, nv, P.nout};
+    pwrite_or_die(P.fd, sizes, sizeof(sizes), 0);
+  }
+
+  pthread_mutex_init(&P.lock, NULL);
+  pthread_t *tid = malloc(P.nthreads * sizeof(*tid));
+  for (int t = 0; t < P.nthreads; ++t)
+    pthread_create(&tid[t], NULL, worker, &P);
+  for (int t = 0; t < P.nthreads; ++t)
+    pthread_join(tid[t], NULL);
+  free(tid);
+
+  if (P.dedup) write_dedup(&P, nv);
+
+  if (close(P.fd) != 0) { perror(argv[optind]); exit(1); }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  double secs = (t1.tv_sec - t0.tv_sec) + 1.0e-9 * (t1.tv_nsec - t0.tv_nsec);
+  fprintf(stderr, "scale %d: %lu vertices, %lu entries written, %d threads, %.3f s\n",
+          P.scale, (unsigned long)nv, (unsigned long)P.nout, P.nthreads, secs);
+
+  free(P.all);
+  free(P.perm);
+  return 0;
+}
@@ -0,0 +1,131 @@
+#include <math.h>
+#include <GraphBLAS.h>
+
+#include "graph.h"
+
+// Delta-stepping shortest paths (Meyer & Sanders) on the min-plus
+// semiring, for nsources sources at once: row r of the k x N matrix T
+// holds tentative distances from sources[r].  Distances below lo are
+// final.  Each round takes the bucket [lo, lo + delta) of every row,
+// relaxes light edges (weight <= delta) from it until nothing in the
+// bucket improves, then relaxes heavy edges once from everything the
+// bucket settled.  Empty buckets are skipped by jumping lo to the
+// smallest unsettled distance.  Weights must be non-negative.
+//
+// *relaxations counts edges scanned, for relaxations per second.
+
+// Edges leaving the entries of F: sum over F(r, v) of deg(v).
+static uint64_t
+edges_from(GrB_Matrix F, GrB_Vector deg, GrB_Vector per_row)
+{
+  int64_t n = 0;
+  GrB_mxv(per_row, GrB_NULL, GrB_NULL, GxB_PLUS_SECOND_INT64, F, deg, GrB_NULL);
+  GrB_reduce(&n, GrB_NULL, GrB_PLUS_MONOID_INT64, per_row, GrB_NULL);
+  return n;
+}
+
+int sssp_batch(GrB_Matrix *dist, uint64_t *relaxations,
+               struct graph *G, const GrB_Index *sources, GrB_Index nsources,
+               double delta)
+{
+  GrB_Matrix A = G->A;
+  GrB_Index N = graph_nrows(G), k = nsources;
+
+  *relaxations = 0;
+  GrB_Matrix_new(dist, GrB_FP64, k, N);
+  if (N == 0 || k == 0) return 0;
+
+  GrB_Matrix T = *dist;
+  for (GrB_Index r = 0; r < k; ++r)
+    GrB_Matrix_setElement(T, 0.0, r, sources[r]);
+
+  GrB_Matrix AL, AH;
+  GrB_Matrix_new(&AL, GrB_FP64, N, N);
+  GrB_Matrix_new(&AH, GrB_FP64, N, N);
+  GrB_select(AL, GrB_NULL, GrB_NULL, GrB_VALUELE_FP64, A, delta, GrB_NULL);
+  GrB_select(AH, GrB_NULL, GrB_NULL, GrB_VALUEGT_FP64, A, delta, GrB_NULL);
+
+  GrB_Vector ones, ldeg, hdeg, per_row;
+  GrB_Vector_new(&ones, GrB_INT64, N);
+  GrB_assign(ones, GrB_NULL, GrB_NULL, (int64_t)1, GrB_ALL, N, GrB_NULL);
+  GrB_Vector_new(&ldeg, GrB_INT64, N);
+  GrB_Vector_new(&hdeg, GrB_INT64, N);
+  GrB_mxv(ldeg, GrB_NULL, GrB_NULL, GxB_PLUS_PAIR_INT64, AL, ones, GrB_NULL);
+  GrB_mxv(hdeg, GrB_NULL, GrB_NULL, GxB_PLUS_PAIR_INT64, AH, ones, GrB_NULL);
+  GrB_Vector_new(&per_row, GrB_INT64, k);
+
+  GrB_Matrix B, S, Req, C, tmp;
+  GrB_Matrix_new(&B, GrB_FP64, k, N);
+  GrB_Matrix_new(&S, GrB_BOOL, k, N);
+  GrB_Matrix_new(&Req, GrB_FP64, k, N);
+  GrB_Matrix_new(&C, GrB_BOOL, k, N);
+  GrB_Matrix_new(&tmp, GrB_FP64, k, N);
+
+  double lo = 0.0;
+  int buckets = 0;
+  for (;;) {
+    GrB_Index nb;
+    GrB_select(tmp, GrB_NULL, GrB_NULL, GrB_VALUEGE_FP64, T, lo, GrB_NULL);
+    GrB_Matrix_nvals(&nb, tmp);
+    if (nb == 0) break;
+    double next = INFINITY;
+    GrB_reduce(&next, GrB_NULL, GrB_MIN_MONOID_FP64, tmp, GrB_NULL);
+    lo = delta * floor(next / delta);
+    const double hi = lo + delta;
+    ++buckets;
+
+    GrB_select(B, GrB_NULL, GrB_NULL, GrB_VALUELT_FP64, tmp, hi, GrB_NULL);
+    GrB_Matrix_clear(S);
+
+    for (GrB_Matrix_nvals(&nb, B); nb > 0; GrB_Matrix_nvals(&nb, B)) {
+      *relaxations += edges_from(B, ldeg, per_row);
+      GrB_assign(S, B, GrB_NULL, true, GrB_ALL, k, GrB_ALL, N, GrB_DESC_S);
+
+      GrB_mxm(Req, GrB_NULL, GrB_NULL, GrB_MIN_PLUS_SEMIRING_FP64, B, AL, GrB_NULL);
+
+      // C: where Req beats T, including where T has no entry yet.
+      GrB_eWiseMult(C, GrB_NULL, GrB_NULL, GrB_LT_FP64, Req, T, GrB_NULL);
+      GrB_apply(C, T, GrB_NULL, GxB_ONE_FP64, Req, GrB_DESC_SC);
+      GrB_select(C, GrB_NULL, GrB_NULL, GrB_VALUEEQ_BOOL, C, true, GrB_NULL);
+
+      GrB_eWiseAdd(T, GrB_NULL, GrB_NULL, GrB_MIN_FP64, T, Req, GrB_NULL);
+
+      // Improved entries still inside the bucket go round again.
+      GrB_apply(B, C, GrB_NULL, GrB_IDENTITY_FP64, T, GrB_DESC_RS);
+      GrB_select(B, GrB_NULL, GrB_NULL, GrB_VALUELT_FP64, B, hi, GrB_NULL);
+    }
+
+    *relaxations += edges_from(S, hdeg, per_row);
+    GrB_apply(tmp, S, GrB_NULL, GrB_IDENTITY_FP64, T, GrB_DESC_RS);
+    GrB_mxm(Req, GrB_NULL, GrB_NULL, GrB_MIN_PLUS_SEMIRING_FP64, tmp, AH, GrB_NULL);
+    GrB_eWiseAdd(T, GrB_NULL, GrB_NULL, GrB_MIN_FP64, T, Req, GrB_NULL);
+
+    lo = hi;
+  }
+
+  GrB_free(&tmp);
+  GrB_free(&C);
+  GrB_free(&Req);
+  GrB_free(&S);
+  GrB_free(&B);
+  GrB_free(&per_row);
+  GrB_free(&hdeg);
+  GrB_free(&ldeg);
+  GrB_free(&ones);
+  GrB_free(&AH);
+  GrB_free(&AL);
+
+  return buckets;
+}
+
+int sssp(GrB_Vector *dist, uint64_t *relaxations,
+         struct graph *G, GrB_Index source, double delta)
+{
+  GrB_Matrix T;
+  GrB_Index N = graph_nrows(G);
+  int buckets = sssp_batch(&T, relaxations, G, &source, 1, delta);
+  GrB_Vector_new(dist, GrB_FP64, N);
+  GrB_Col_extract(*dist, GrB_NULL, GrB_NULL, T, GrB_ALL, N, 0, GrB_DESC_T0);
+  GrB_free(&T);
+  return buckets;
+}
@@ -0,0 +1,68 @@
+#include <GraphBLAS.h>
+
+// Top-k entries of a score vector by value, largest first, ties going
+// to the smaller index.  One pass over the entries keeps the best k in
+// a min-heap stored in idx/val, then the heap is sorted in place, so
+// the cost is O(nvals log k) with no copy of the vector.  idx and val
+// must hold k entries.  Returns the number found, min(k, nvals).
+
+static inline int
+worse(double va, GrB_Index ia, double vb, GrB_Index ib)
+{
+  return va < vb || (va == vb && ia > ib);
+}
+
+static void
+sift_down(GrB_Index *idx, double *val, GrB_Index n, GrB_Index p)
+{
+  for (;;) {
+    GrB_Index c = 2 * p + 1;
+    if (c >= n) break;
+    if (c + 1 < n && worse(val[c+1], idx[c+1], val[c], idx[c])) ++c;
+    if (!worse(val[c], idx[c], val[p], idx[p])) break;
+    double tv = val[p]; val[p] = val[c]; val[c] = tv;
+    GrB_Index ti = idx[p]; idx[p] = idx[c]; idx[c] = ti;
+    p = c;
+  }
+}
+
+GrB_Index
+topk_pr(GrB_Index *idx, double *val, GrB_Index k, GrB_Vector pr)
+{
+  if (k == 0) return 0;
+
+  GrB_Index n = 0;
+  GxB_Iterator it;
+  GxB_Iterator_new(&it);
+  GxB_Vector_Iterator_attach(it, pr, GrB_NULL);
+  GrB_Info info = GxB_Vector_Iterator_seek(it, 0);
+  while (info != GxB_EXHAUSTED) {
+    GrB_Index i = GxB_Vector_Iterator_getIndex(it);
+    double x = GxB_Iterator_get_FP64(it);
+    if (n < k) {
+      // Sift up the new leaf.
+      GrB_Index c = n++;
+      while (c > 0) {
+        GrB_Index p = (c - 1) / 2;
+        if (!worse(x, i, val[p], idx[p])) break;
+        val[c] = val[p]; idx[c] = idx[p];
+        c = p;
+      }
+      val[c] = x; idx[c] = i;
+    } else if (worse(val[0], idx[0], x, i)) {
+      val[0] = x; idx[0] = i;
+      sift_down(idx, val, n, 0);
+    }
+    info = GxB_Vector_Iterator_next(it);
+  }
+  GrB_free(&it);
+
+  // Repeatedly move the worst to the end: best-first order.
+  for (GrB_Index m = n; m > 1; --m) {
+    double tv = val[0]; val[0] = val[m-1]; val[m-1] = tv;
+    GrB_Index ti = idx[0]; idx[0] = idx[m-1]; idx[m-1] = ti;
+    sift_down(idx, val, m - 1, 0);
+  }
+
+  return n;
+}